@@ -71,7 +71,7 @@ def _setValue(self, value, typeString = ''):
 
 def _getValue(self):
     "Return the typed value of an element."
-    value = self._getValue()
+    value = self.getConstValue()
     return value.getData() if value else None
 
 def _getDefaultValue(self):
@@ -250,6 +250,7 @@ class TestMaterialX(unittest.TestCase):
         # Bind the roughness input to a value.
         instanceRoughness = shaderNode.setInputValue('roughness', 0.5)
         self.assertTrue(instanceRoughness.getValue() == 0.5)
+        self.assertTrue(instanceRoughness.getConstValue().getData() == 0.5)
         self.assertTrue(instanceRoughness.getDefaultValue() == 0.25)
 
         # Create a look for the material.
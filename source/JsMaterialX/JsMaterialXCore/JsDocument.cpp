@@ -26,6 +26,8 @@ EMSCRIPTEN_BINDINGS(document)
         .function("setDataLibrary", &mx::Document::setDataLibrary)
         .function("getDataLibrary", &mx::Document::getDataLibrary)
         .function("hasDataLibrary", &mx::Document::hasDataLibrary)
+        .function("freeze", &mx::Document::freeze)
+        .function("isFrozen", &mx::Document::isFrozen)
         .function("importLibrary", &mx::Document::importLibrary)
         .function("getReferencedSourceUris", ems::optional_override([](mx::Document &self) {
             mx::StringSet set = self.getReferencedSourceUris();
@@ -98,7 +100,9 @@ EMSCRIPTEN_BINDINGS(document)
         .function("getUnitTypeDefs", &mx::Document::getUnitTypeDefs)
         .function("removeUnitTypeDef", &mx::Document::removeUnitTypeDef)
         .function("getVersionIntegers", &mx::Document::getVersionIntegers)
-        .function("upgradeVersion", &mx::Document::upgradeVersion)
+        .function("upgradeVersion", ems::optional_override([](mx::Document& self) {
+            self.upgradeVersion();
+        }))
         .function("setColorManagementSystem", &mx::Document::setColorManagementSystem)
         .function("hasColorManagementSystem", &mx::Document::hasColorManagementSystem)
         .function("getColorManagementSystem", &mx::Document::getColorManagementSystem)
@@ -106,6 +110,10 @@ EMSCRIPTEN_BINDINGS(document)
         .function("hasColorManagementConfig", &mx::Document::hasColorManagementConfig)
         .function("getColorManagementConfig", &mx::Document::getColorManagementConfig)
         .function("invalidateCache", &mx::Document::invalidateCache)
+        .function("setValueCaching", &mx::Document::setValueCaching)
+        .function("getValueCaching", &mx::Document::getValueCaching)
+        .function("setElementPooling", &mx::Document::setElementPooling)
+        .function("getElementPooling", &mx::Document::getElementPooling)
         .class_property("CATEGORY", &mx::Document::CATEGORY)
         .class_property("CMS_ATTRIBUTE", &mx::Document::CMS_ATTRIBUTE)
         .class_property("CMS_CONFIG_ATTRIBUTE", &mx::Document::CMS_CONFIG_ATTRIBUTE);
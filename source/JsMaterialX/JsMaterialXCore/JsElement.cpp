@@ -64,6 +64,7 @@ EMSCRIPTEN_BINDINGS(element)
             }
             return res;
         }))
+        .function("getContentHash", &mx::Element::getContentHash)
         .function("setCategory", &mx::Element::setCategory)
         .function("getCategory", &mx::Element::getCategory)
         .function("setName", &mx::Element::setName)
@@ -233,6 +234,7 @@ EMSCRIPTEN_BINDINGS(element)
         BIND_VALUE_ELEMENT_FUNC_INSTANCE(StringArray, mx::StringVec)
         .function("hasValue", &mx::ValueElement::hasValue)
         .function("getValue", &mx::ValueElement::getValue)
+        .function("getConstValue", &mx::ValueElement::getConstValue)
         BIND_MEMBER_FUNC("getResolvedValue", mx::ValueElement, getResolvedValue, 0, 1, mx::StringResolverPtr)
         .function("getDefaultValue", &mx::ValueElement::getDefaultValue)
         .function("setUnit", &mx::ValueElement::setUnit)
@@ -61,6 +61,8 @@ EMSCRIPTEN_BINDINGS(node)
         .function("addInterfaceName", &mx::NodeGraph::addInterfaceName)
         .function("removeInterfaceName", &mx::NodeGraph::removeInterfaceName)
         .function("modifyInterfaceName", &mx::NodeGraph::modifyInterfaceName)
+        .function("hasDeferredBody", &mx::NodeGraph::hasDeferredBody)
+        .function("loadDeferredBody", &mx::NodeGraph::loadDeferredBody)
         .class_property("CATEGORY", &mx::NodeGraph::CATEGORY);
 
     ems::class_<mx::Backdrop, ems::base<mx::Element>>("Backdrop")
@@ -30,6 +30,9 @@ EMSCRIPTEN_BINDINGS(xmlio)
             })
         .property("readComments", &mx::XmlReadOptions::readComments)
         .property("upgradeVersion", &mx::XmlReadOptions::upgradeVersion)                
+        .property("skipDataLibraryXIncludes", &mx::XmlReadOptions::skipDataLibraryXIncludes)
+        .property("streamingRead", &mx::XmlReadOptions::streamingRead)
+        .property("deferNodeGraphBodies", &mx::XmlReadOptions::deferNodeGraphBodies)
         .property("parentXIncludes", &mx::XmlReadOptions::parentXIncludes);
 
     ems::class_<mx::XmlWriteOptions>("XmlWriteOptions")
@@ -36,6 +36,7 @@ EMSCRIPTEN_BINDINGS(GenOptions)
         .property("targetDistanceUnit", &mx::GenOptions::targetDistanceUnit)
         .property("addUpstreamDependencies", &mx::GenOptions::addUpstreamDependencies)
         .property("emitColorTransforms", &mx::GenOptions::emitColorTransforms)
+        .property("optimizeShaderGraph", &mx::GenOptions::optimizeShaderGraph)
         .property("hwTransparency", &mx::GenOptions::hwTransparency)
         .property("hwSpecularEnvironmentMethod", &mx::GenOptions::hwSpecularEnvironmentMethod)
         .property("hwDirectionalAlbedoMethod", &mx::GenOptions::hwDirectionalAlbedoMethod)
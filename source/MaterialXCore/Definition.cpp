@@ -34,6 +34,34 @@ const string AttributeDef::VALUE_ATTRIBUTE = "value";
 const string AttributeDef::ELEMENTS_ATTRIBUTE = "elements";
 const string AttributeDef::EXPORTABLE_ATTRIBUTE = "exportable";
 
+namespace
+{
+
+// Register the attribute names above as interned strings, so that attribute
+// lookups with these constants match stored names by address.
+[[maybe_unused]] const bool ATTRIBUTE_NAMES_INTERNED = []()
+{
+    for (const string* name : { &NodeDef::NODE_ATTRIBUTE, &NodeDef::NODE_GROUP_ATTRIBUTE,
+                                &Implementation::FILE_ATTRIBUTE, &Implementation::FUNCTION_ATTRIBUTE })
+    {
+        internStaticString(*name);
+    }
+    return true;
+}();
+
+// Read the deferred body of a graph implementation before it is returned.
+InterfaceElementPtr loadImplementation(InterfaceElementPtr impl)
+{
+    NodeGraphPtr graph = impl ? impl->asA<NodeGraph>() : nullptr;
+    if (graph)
+    {
+        graph->loadDeferredBody();
+    }
+    return impl;
+}
+
+} // anonymous namespace
+
 //
 // NodeDef methods
 //
@@ -65,7 +93,7 @@ InterfaceElementPtr NodeDef::getImplementation(const string& target) const
 
     if (target.empty())
     {
-        return !interfaces.empty() ? interfaces[0] : InterfaceElementPtr();
+        return !interfaces.empty() ? loadImplementation(interfaces[0]) : InterfaceElementPtr();
     }
 
     // Get all candidate targets matching the given target,
@@ -81,7 +109,7 @@ InterfaceElementPtr NodeDef::getImplementation(const string& target) const
             const std::string& interfaceTarget = interface->getTarget();
             if (!interfaceTarget.empty() && targetStringsMatch(interfaceTarget, candidateTarget))
             {
-                return interface;
+                return loadImplementation(interface);
             }
         }
     }
@@ -93,7 +121,7 @@ InterfaceElementPtr NodeDef::getImplementation(const string& target) const
         const std::string& interfaceTarget = interface->getTarget();
         if (interfaceTarget.empty())
         {
-            return interface;
+            return loadImplementation(interface);
         }
     }
 
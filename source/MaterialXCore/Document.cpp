@@ -5,6 +5,10 @@
 
 #include <MaterialXCore/Document.h>
 
+#include <MaterialXCore/Util.h>
+
+#include <algorithm>
+#include <atomic>
 #include <mutex>
 
 MATERIALX_NAMESPACE_BEGIN
@@ -12,6 +16,18 @@ MATERIALX_NAMESPACE_BEGIN
 const string Document::CMS_ATTRIBUTE = "cms";
 const string Document::CMS_CONFIG_ATTRIBUTE = "cmsconfig";
 
+namespace
+{
+
+// Return a new revision number, greater than any previously returned.
+size_t nextRevision()
+{
+    static std::atomic<size_t> counter(0);
+    return ++counter;
+}
+
+} // anonymous namespace
+
 //
 // Document factory function
 //
@@ -27,100 +43,482 @@ DocumentPtr createDocument()
 
 class Document::Cache
 {
+  public:
+    template <class T> struct Entry
+    {
+        const Element* source;
+        shared_ptr<T> target;
+    };
+    template <class T> using EntryMap = std::unordered_map<string, vector<Entry<T>>>;
+
+    // The precomputed signature of a nodedef, allowing nodes to be matched
+    // to nodedefs without traversing their inheritance.
+    struct NodeDefSignature
+    {
+        bool matchesTarget(const string& target, const StringVec& targets) const
+        {
+            if (anyTarget || target.empty())
+            {
+                return true;
+            }
+            for (const string& str : targets)
+            {
+                if (this->targets.count(str))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool matchesVersion(const string& version) const
+        {
+            return this->version == version || (defaultVersion && version.empty());
+        }
+
+        bool matchesInputs(const vector<InputPtr>& inputs, uint64_t inputMask) const
+        {
+            if (inputMask & ~this->inputMask)
+            {
+                return false;
+            }
+            for (const InputPtr& input : inputs)
+            {
+                auto it = inputTypes.find(input->getName());
+                if (it == inputTypes.end() || it->second != input->getType())
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        NodeDefPtr nodeDef;
+        bool anyTarget;
+        StringSet targets;
+        string version;
+        bool defaultVersion;
+        uint64_t inputMask;
+        StringMap inputTypes;
+    };
+
   public:
     Cache() :
-        valid(false)
+        valid(false),
+        frozen(false),
+        valueCaching(true),
+        revision(nextRevision())
     {
     }
     ~Cache() = default;
 
     void refresh()
     {
-        // Thread synchronization for multiple concurrent readers of a single document.
+        // The cache of a frozen document is complete and immutable.
+        if (frozen)
+        {
+            return;
+        }
+
+        // Once the cache has been published as valid, concurrent readers of a
+        // single document proceed without synchronization.
+        if (valid.load(std::memory_order_acquire))
+        {
+            return;
+        }
+
+        // Thread synchronization for multiple concurrent readers that find
+        // the cache invalid.
         std::lock_guard<std::mutex> guard(mutex);
 
-        if (!valid)
+        if (!valid.load(std::memory_order_relaxed))
         {
             // Clear the existing cache.
             portElementMap.clear();
             nodeDefMap.clear();
+            nodeDefSignatureMap.clear();
             implementationMap.clear();
+            nodeGraphReferences.clear();
+            nodeDefReferences.clear();
 
-            // Traverse the document to build a new cache.
+            // Traverse the document to build a new cache.  Since elements are
+            // visited in document order, entries may simply be appended.
             for (ElementPtr elem : doc.lock()->traverseTree())
             {
-                const string& nodeName = elem->getAttribute(PortElement::NODE_NAME_ATTRIBUTE);
-                const string& nodeGraphName = elem->getAttribute(PortElement::NODE_GRAPH_ATTRIBUTE);
-                const string& nodeString = elem->getAttribute(NodeDef::NODE_ATTRIBUTE);
-                const string& nodeDefString = elem->getAttribute(InterfaceElement::NODE_DEF_ATTRIBUTE);
+                addEntries(elem, false);
+            }
+
+            // Publish the new cache to other threads.
+            valid.store(true, std::memory_order_release);
+        }
+    }
+
+    // Add the cache entries for the given element, and optionally for all of
+    // its descendants.
+    void addElement(const ConstElementPtr& elem, bool recursive)
+    {
+        if (!valid || isNodeDefChild(elem))
+        {
+            return;
+        }
+        if (recursive)
+        {
+            for (ElementPtr descendant : elem->traverseTree())
+            {
+                addEntries(descendant, true);
+            }
+        }
+        else
+        {
+            addEntries(elem, true);
+        }
+    }
+
+    // Remove the cache entries for the given element, and optionally for all
+    // of its descendants.
+    void removeElement(const ConstElementPtr& elem, bool recursive)
+    {
+        if (!valid || isNodeDefChild(elem))
+        {
+            return;
+        }
+        if (recursive)
+        {
+            for (ElementPtr descendant : elem->traverseTree())
+            {
+                removeEntries(descendant);
+            }
+        }
+        else
+        {
+            removeEntries(elem);
+        }
+    }
+
+    // Handle the addition, removal, or renaming of a nodegraph that may be
+    // referenced by name from implementation elements, or of a nodedef that
+    // may be inherited from by other nodedefs.
+    void updateReferencedName(const ConstElementPtr& elem, const string& name)
+    {
+        if (!valid || isNodeDefChild(elem) || elem->getParent() != doc.lock())
+        {
+            return;
+        }
+        if (elem->isA<NodeGraph>() && nodeGraphReferences.count(name))
+        {
+            valid = false;
+        }
+        else if (elem->isA<NodeDef>() &&
+                 (nodeDefReferences.count(name) || nodeDefReferences.count(elem->getQualifiedName(name))))
+        {
+            valid = false;
+        }
+    }
+
+    // Return the bit representing the given input name and type in the
+    // input mask of a signature.
+    static uint64_t getInputBit(const string& name, const string& type)
+    {
+        size_t hash = std::hash<string>()(name) ^ (std::hash<string>()(type) << 1);
+        return (uint64_t) 1 << (hash % 64);
+    }
 
-                if (!nodeName.empty())
+  private:
+    void addEntries(const ConstElementPtr& elem, bool ordered)
+    {
+        const string& nodeName = elem->getAttribute(PortElement::NODE_NAME_ATTRIBUTE);
+        const string& nodeGraphName = elem->getAttribute(PortElement::NODE_GRAPH_ATTRIBUTE);
+        const string& nodeString = elem->getAttribute(NodeDef::NODE_ATTRIBUTE);
+        const string& nodeDefString = elem->getAttribute(InterfaceElement::NODE_DEF_ATTRIBUTE);
+
+        if (!nodeName.empty())
+        {
+            PortElementPtr portElem = std::const_pointer_cast<Element>(elem)->asA<PortElement>();
+            if (portElem)
+            {
+                insertEntry(portElementMap[portElem->getQualifiedName(nodeName)], elem, portElem, ordered);
+            }
+        }
+        else
+        {
+            if (!nodeGraphName.empty())
+            {
+                PortElementPtr portElem = std::const_pointer_cast<Element>(elem)->asA<PortElement>();
+                if (portElem)
                 {
-                    PortElementPtr portElem = elem->asA<PortElement>();
-                    if (portElem)
-                    {
-                        portElementMap[portElem->getQualifiedName(nodeName)].push_back(portElem);
-                    }
+                    insertEntry(portElementMap[portElem->getQualifiedName(nodeGraphName)], elem, portElem, ordered);
                 }
-                else
+            }
+        }
+        if (!nodeString.empty())
+        {
+            NodeDefPtr nodeDef = std::const_pointer_cast<Element>(elem)->asA<NodeDef>();
+            if (nodeDef)
+            {
+                const string qualifiedNode = nodeDef->getQualifiedName(nodeString);
+                insertEntry(nodeDefMap[qualifiedNode], elem, nodeDef, ordered);
+                insertEntry(nodeDefSignatureMap[qualifiedNode][nodeDef->getType()], elem, createSignature(nodeDef), ordered);
+                if (nodeDef->hasInheritString())
                 {
-                    if (!nodeGraphName.empty())
-                    {
-                        PortElementPtr portElem = elem->asA<PortElement>();
-                        if (portElem)
-                        {
-                            portElementMap[portElem->getQualifiedName(nodeGraphName)].push_back(portElem);
-                        }
-                    }
+                    nodeDefReferences[nodeDef->getInheritString()]++;
                 }
-                if (!nodeString.empty())
+            }
+        }
+        if (!nodeDefString.empty())
+        {
+            InterfaceElementPtr interface = std::const_pointer_cast<Element>(elem)->asA<InterfaceElement>();
+            if (interface)
+            {
+                if (interface->isA<NodeGraph>())
+                {
+                    insertEntry(implementationMap[interface->getQualifiedName(nodeDefString)], elem, interface, ordered);
+                }
+                ImplementationPtr impl = interface->asA<Implementation>();
+                if (impl)
                 {
-                    NodeDefPtr nodeDef = elem->asA<NodeDef>();
-                    if (nodeDef)
+                    // Check for implementation which specifies a nodegraph as the implementation
+                    const string& nodeGraphString = impl->getNodeGraph();
+                    if (!nodeGraphString.empty())
+                    {
+                        nodeGraphReferences[nodeGraphString]++;
+                        NodeGraphPtr nodeGraph = impl->getDocument()->getNodeGraph(nodeGraphString);
+                        if (nodeGraph)
+                            insertEntry(implementationMap[interface->getQualifiedName(nodeDefString)], elem, InterfaceElementPtr(nodeGraph), ordered);
+                    }
+                    else
                     {
-                        nodeDefMap[nodeDef->getQualifiedName(nodeString)].push_back(nodeDef);
+                        insertEntry(implementationMap[interface->getQualifiedName(nodeDefString)], elem, interface, ordered);
                     }
                 }
-                if (!nodeDefString.empty())
+            }
+        }
+    }
+
+    void removeEntries(const ConstElementPtr& elem)
+    {
+        const string& nodeName = elem->getAttribute(PortElement::NODE_NAME_ATTRIBUTE);
+        const string& nodeGraphName = elem->getAttribute(PortElement::NODE_GRAPH_ATTRIBUTE);
+        const string& nodeString = elem->getAttribute(NodeDef::NODE_ATTRIBUTE);
+        const string& nodeDefString = elem->getAttribute(InterfaceElement::NODE_DEF_ATTRIBUTE);
+
+        if (!nodeName.empty())
+        {
+            if (elem->isA<PortElement>())
+            {
+                eraseEntry(portElementMap, elem->getQualifiedName(nodeName), elem, true);
+            }
+        }
+        else
+        {
+            if (!nodeGraphName.empty() && elem->isA<PortElement>())
+            {
+                eraseEntry(portElementMap, elem->getQualifiedName(nodeGraphName), elem, true);
+            }
+        }
+        if (!nodeString.empty() && elem->isA<NodeDef>())
+        {
+            const string qualifiedNode = elem->getQualifiedName(nodeString);
+            eraseEntry(nodeDefMap, qualifiedNode, elem, true);
+            auto it = nodeDefSignatureMap.find(qualifiedNode);
+            if (it != nodeDefSignatureMap.end())
+            {
+                eraseEntry(it->second, elem->asA<NodeDef>()->getType(), elem, true);
+                if (it->second.empty())
                 {
-                    InterfaceElementPtr interface = elem->asA<InterfaceElement>();
-                    if (interface)
+                    nodeDefSignatureMap.erase(it);
+                }
+            }
+            else
+            {
+                valid = false;
+            }
+            if (nodeDefReferences.count(elem->getName()) || nodeDefReferences.count(elem->getQualifiedName(elem->getName())))
+            {
+                // Nodedefs that inherit from this one may be affected.
+                valid = false;
+            }
+            if (elem->hasInheritString())
+            {
+                auto refIt = nodeDefReferences.find(elem->getInheritString());
+                if (refIt != nodeDefReferences.end() && --refIt->second == 0)
+                {
+                    nodeDefReferences.erase(refIt);
+                }
+            }
+        }
+        if (!nodeDefString.empty())
+        {
+            if (elem->isA<NodeGraph>())
+            {
+                eraseEntry(implementationMap, elem->getQualifiedName(nodeDefString), elem, true);
+            }
+            else if (elem->isA<Implementation>())
+            {
+                if (!nodeGraphName.empty())
+                {
+                    auto it = nodeGraphReferences.find(nodeGraphName);
+                    if (it != nodeGraphReferences.end() && --it->second == 0)
                     {
-                        if (interface->isA<NodeGraph>())
-                        {
-                            implementationMap[interface->getQualifiedName(nodeDefString)].push_back(interface);
-                        }
-                        ImplementationPtr impl = interface->asA<Implementation>();
-                        if (impl)
-                        {
-                            // Check for implementation which specifies a nodegraph as the implementation
-                            const string& nodeGraphString = impl->getNodeGraph();
-                            if (!nodeGraphString.empty())
-                            {
-                                NodeGraphPtr nodeGraph = impl->getDocument()->getNodeGraph(nodeGraphString);
-                                if (nodeGraph)
-                                    implementationMap[interface->getQualifiedName(nodeDefString)].push_back(nodeGraph);
-                            }
-                            else
-                            {
-                                implementationMap[interface->getQualifiedName(nodeDefString)].push_back(interface);
-                            }
-                        }
+                        nodeGraphReferences.erase(it);
                     }
+
+                    // The referenced nodegraph may not have existed when the entry was added.
+                    eraseEntry(implementationMap, elem->getQualifiedName(nodeDefString), elem, false);
+                }
+                else
+                {
+                    eraseEntry(implementationMap, elem->getQualifiedName(nodeDefString), elem, true);
                 }
             }
+        }
+    }
+
+    // Return true if the given element is a child of a nodedef.  Since these
+    // elements contribute to the signatures of nodedefs and of any nodedefs
+    // that inherit from them, changes to them invalidate the cache.
+    bool isNodeDefChild(const ConstElementPtr& elem)
+    {
+        ConstElementPtr parent = elem->getParent();
+        if (parent && parent->isA<NodeDef>())
+        {
+            valid = false;
+            return true;
+        }
+        return false;
+    }
 
-            valid = true;
+    static shared_ptr<NodeDefSignature> createSignature(const NodeDefPtr& nodeDef)
+    {
+        auto signature = std::make_shared<NodeDefSignature>();
+        signature->nodeDef = nodeDef;
+        const string& target = nodeDef->getTarget();
+        signature->anyTarget = target.empty();
+        for (const string& str : splitString(target, ARRAY_VALID_SEPARATORS))
+        {
+            signature->targets.insert(str);
+        }
+        signature->version = nodeDef->getVersionString();
+        signature->defaultVersion = nodeDef->getDefaultVersion();
+        signature->inputMask = 0;
+        for (const InputPtr& input : nodeDef->getActiveInputs())
+        {
+            signature->inputTypes[input->getName()] = input->getType();
+            signature->inputMask |= getInputBit(input->getName(), input->getType());
         }
+        return signature;
+    }
+
+    // Insert an entry into the given vector, maintaining the document order
+    // of source elements.  Entries are typically appended to the end of the
+    // document, so the search proceeds from the back of the vector.
+    template <class T> void insertEntry(vector<Entry<T>>& entries, const ConstElementPtr& source, shared_ptr<T> target, bool ordered)
+    {
+        auto it = entries.end();
+        if (ordered)
+        {
+            while (it != entries.begin() && precedes(source.get(), std::prev(it)->source))
+            {
+                --it;
+            }
+        }
+        entries.insert(it, { source.get(), std::move(target) });
+    }
+
+    // Erase the entry with the given source element.  If a required entry is
+    // not found, then the cache is inconsistent and is marked for rebuilding.
+    template <class T> void eraseEntry(EntryMap<T>& map, const string& key, const ConstElementPtr& source, bool required)
+    {
+        auto mapIt = map.find(key);
+        if (mapIt != map.end())
+        {
+            vector<Entry<T>>& entries = mapIt->second;
+            auto it = std::find_if(entries.begin(), entries.end(), [&source](const Entry<T>& entry)
+            {
+                return entry.source == source.get();
+            });
+            if (it != entries.end())
+            {
+                entries.erase(it);
+                if (entries.empty())
+                {
+                    map.erase(mapIt);
+                }
+                return;
+            }
+        }
+        if (required)
+        {
+            valid = false;
+        }
+    }
+
+    // Return true if element a precedes element b in document order.
+    static bool precedes(const Element* a, const Element* b)
+    {
+        if (a == b)
+        {
+            return false;
+        }
+        vector<const Element*> pathA, pathB;
+        for (const Element* elem = a; elem; elem = elem->getParent().get())
+        {
+            pathA.push_back(elem);
+        }
+        for (const Element* elem = b; elem; elem = elem->getParent().get())
+        {
+            pathB.push_back(elem);
+        }
+
+        // Walk down from the root to the first divergent ancestor.
+        auto itA = pathA.rbegin();
+        auto itB = pathB.rbegin();
+        const Element* parent = nullptr;
+        while (itA != pathA.rend() && itB != pathB.rend() && *itA == *itB)
+        {
+            parent = *itA;
+            ++itA;
+            ++itB;
+        }
+        if (itA == pathA.rend())
+        {
+            return true;
+        }
+        if (itB == pathB.rend() || !parent)
+        {
+            return false;
+        }
+
+        // New children are appended, so search the sibling order from the back.
+        const ElementVec& children = parent->getChildren();
+        for (auto it = children.rbegin(); it != children.rend(); ++it)
+        {
+            if (it->get() == *itA)
+            {
+                return false;
+            }
+            if (it->get() == *itB)
+            {
+                return true;
+            }
+        }
+        return false;
     }
 
   public:
     weak_ptr<Document> doc;
     std::mutex mutex;
-    bool valid;
-    std::unordered_map<string, std::vector<PortElementPtr>> portElementMap;
-    std::unordered_map<string, std::vector<NodeDefPtr>> nodeDefMap;
-    std::unordered_map<string, std::vector<InterfaceElementPtr>> implementationMap;
+    std::recursive_mutex deferredBodyMutex;
+    std::atomic<bool> valid;
+    bool frozen;
+    std::atomic<bool> valueCaching;
+    std::atomic<size_t> revision;
+    StringSet sourceUris;
+    EntryMap<PortElement> portElementMap;
+    EntryMap<NodeDef> nodeDefMap;
+    std::unordered_map<string, EntryMap<NodeDefSignature>> nodeDefSignatureMap;
+    EntryMap<InterfaceElement> implementationMap;
+    std::unordered_map<string, size_t> nodeGraphReferences;
+    std::unordered_map<string, size_t> nodeDefReferences;
 };
 
 //
@@ -276,8 +674,36 @@ void Document::importLibrary(const ConstDocumentPtr& library)
     }
 }
 
+void Document::freeze()
+{
+    if (_cache->frozen)
+    {
+        return;
+    }
+
+    // Read all deferred graph bodies, which could not be read once frozen.
+    for (NodeGraphPtr graph : getNodeGraphs())
+    {
+        graph->loadDeferredBody();
+    }
+
+    _cache->refresh();
+    _cache->sourceUris = getReferencedSourceUris();
+    _cache->frozen = true;
+}
+
+bool Document::isFrozen() const
+{
+    return _cache->frozen;
+}
+
 StringSet Document::getReferencedSourceUris() const
 {
+    if (_cache->frozen)
+    {
+        return _cache->sourceUris;
+    }
+
     StringSet sourceUris;
     for (ElementPtr elem : traverseTree())
     {
@@ -304,14 +730,16 @@ vector<PortElementPtr> Document::getMatchingPorts(const string& nodeName) const
     _cache->refresh();
 
     // Return all port elements matching the given node name.
-    if (_cache->portElementMap.count(nodeName))
+    vector<PortElementPtr> matchingPorts;
+    auto it = _cache->portElementMap.find(nodeName);
+    if (it != _cache->portElementMap.end())
     {
-        return _cache->portElementMap.at(nodeName);
-    }
-    else
-    {
-        return vector<PortElementPtr>();
+        for (const auto& entry : it->second)
+        {
+            matchingPorts.push_back(entry.target);
+        }
     }
+    return matchingPorts;
 }
 
 ValuePtr Document::getGeomPropValue(const string& geomPropName, const string& geom) const
@@ -366,11 +794,15 @@ vector<NodeDefPtr> Document::getMatchingNodeDefs(const string& nodeName) const
     _cache->refresh();
 
     // Return all nodedefs matching the given node name.
-    if (_cache->nodeDefMap.count(nodeName))
+    auto it = _cache->nodeDefMap.find(nodeName);
+    if (it != _cache->nodeDefMap.end())
     {
-        matchingNodeDefs.insert(matchingNodeDefs.end(), _cache->nodeDefMap.at(nodeName).begin(), _cache->nodeDefMap.at(nodeName).end());
+        for (const auto& entry : it->second)
+        {
+            matchingNodeDefs.push_back(entry.target);
+        }
     }
-    
+
     return matchingNodeDefs;
 }
 
@@ -385,14 +817,84 @@ vector<InterfaceElementPtr> Document::getMatchingImplementations(const string& n
     _cache->refresh();
 
     // Return all implementations matching the given nodedef string.
-    if (_cache->implementationMap.count(nodeDef))
+    auto it = _cache->implementationMap.find(nodeDef);
+    if (it != _cache->implementationMap.end())
     {
-        matchingImplementations.insert(matchingImplementations.end(), _cache->implementationMap.at(nodeDef).begin(), _cache->implementationMap.at(nodeDef).end());
+        for (const auto& entry : it->second)
+        {
+            matchingImplementations.push_back(entry.target);
+        }
     }
 
     return matchingImplementations;
 }
 
+NodeDefPtr Document::matchNodeDef(const Node& node, const string& target, bool allowRoughMatch) const
+{
+    // Compute the signature of the node.
+    const string& type = node.getType();
+    const string& version = node.getVersionString();
+    vector<InputPtr> inputs = node.getActiveInputs();
+    uint64_t inputMask = 0;
+    for (const InputPtr& input : inputs)
+    {
+        inputMask |= Cache::getInputBit(input->getName(), input->getType());
+    }
+    StringVec targets = target.empty() ? StringVec() : splitString(target, ARRAY_VALID_SEPARATORS);
+
+    // Gather this document and its data libraries, with the data libraries
+    // taking precedence.
+    vector<const Document*> docs;
+    for (const Document* doc = this; doc; doc = doc->_dataLibrary.get())
+    {
+        docs.insert(docs.begin(), doc);
+    }
+
+    // Search for nodedefs with qualified and unqualified node strings.
+    const string qualifiedCategory = node.getQualifiedName(node.getCategory());
+    StringVec categories = { qualifiedCategory };
+    if (node.getCategory() != qualifiedCategory)
+    {
+        categories.push_back(node.getCategory());
+    }
+    NodeDefPtr roughMatch;
+    for (const string& category : categories)
+    {
+        for (const Document* doc : docs)
+        {
+            doc->_cache->refresh();
+            auto categoryIt = doc->_cache->nodeDefSignatureMap.find(category);
+            if (categoryIt == doc->_cache->nodeDefSignatureMap.end())
+            {
+                continue;
+            }
+            auto typeIt = categoryIt->second.find(type);
+            if (typeIt == categoryIt->second.end())
+            {
+                continue;
+            }
+            for (const auto& entry : typeIt->second)
+            {
+                const Cache::NodeDefSignature& signature = *entry.target;
+                if (!signature.matchesTarget(target, targets) ||
+                    !signature.matchesVersion(version))
+                {
+                    continue;
+                }
+                if (signature.matchesInputs(inputs, inputMask))
+                {
+                    return signature.nodeDef;
+                }
+                if (allowRoughMatch && !roughMatch)
+                {
+                    roughMatch = signature.nodeDef;
+                }
+            }
+        }
+    }
+    return roughMatch;
+}
+
 bool Document::validate(string* message) const
 {
     bool res = true;
@@ -402,9 +904,118 @@ bool Document::validate(string* message) const
     return GraphElement::validate(message) && res;
 }
 
+bool Document::validate(string* message, const ValidationOptions& options) const
+{
+    ValidationScope scope(options);
+    return validate(message);
+}
+
+void Document::setDataLibrary(ConstDocumentPtr dataLibrary)
+{
+    _dataLibrary = dataLibrary;
+    _cache->revision = nextRevision();
+}
+
 void Document::invalidateCache()
 {
+    requireMutable();
     _cache->valid = false;
+    _cache->revision = nextRevision();
+}
+
+void Document::setValueCaching(bool enable)
+{
+    _cache->valueCaching = enable;
+    if (!enable)
+    {
+        for (ElementPtr elem : traverseTree())
+        {
+            ValueElementPtr valueElem = elem->asA<ValueElement>();
+            if (valueElem)
+            {
+                std::atomic_store(&valueElem->_cachedValue, ConstValuePtr());
+            }
+        }
+    }
+}
+
+bool Document::getValueCaching() const
+{
+    return _cache->valueCaching;
+}
+
+void Document::setElementPooling(bool enable)
+{
+    if (enable && !_elementPool)
+    {
+        _elementPool = std::make_shared<ElementPool>();
+    }
+    else if (!enable)
+    {
+        _elementPool.reset();
+    }
+}
+
+size_t Document::getRevision() const
+{
+    // Revisions are drawn from a single counter for all documents, so the
+    // greater of the two revisions increases whenever either document
+    // changes, and whenever a different data library is assigned.
+    size_t revision = _cache->revision;
+    if (_dataLibrary)
+    {
+        revision = std::max(revision, _dataLibrary->getRevision());
+    }
+    return revision;
+}
+
+void Document::requireMutable() const
+{
+    if (_cache->frozen)
+    {
+        throw Exception("Cannot modify a frozen document");
+    }
+}
+
+std::recursive_mutex& Document::getDeferredBodyMutex() const
+{
+    return _cache->deferredBodyMutex;
+}
+
+void Document::onAddElement(const ConstElementPtr& elem)
+{
+    _cache->revision = nextRevision();
+    _cache->updateReferencedName(elem, elem->getName());
+    _cache->addElement(elem, true);
+}
+
+void Document::onRemoveElement(const ConstElementPtr& elem)
+{
+    requireMutable();
+    _cache->revision = nextRevision();
+    _cache->updateReferencedName(elem, elem->getName());
+    _cache->removeElement(elem, true);
+}
+
+void Document::onRenameElement(const ConstElementPtr& elem, const string& newName)
+{
+    requireMutable();
+    _cache->revision = nextRevision();
+    _cache->updateReferencedName(elem, elem->getName());
+    _cache->updateReferencedName(elem, newName);
+}
+
+void Document::onBeginAttributeChange(const ConstElementPtr& elem)
+{
+    requireMutable();
+    _cache->revision = nextRevision();
+    _cache->removeElement(elem, false);
+}
+
+void Document::onEndAttributeChange(const ConstElementPtr& elem)
+{
+    _cache->revision = nextRevision();
+    _cache->addElement(elem, false);
 }
 
 //
@@ -14,6 +14,8 @@
 #include <MaterialXCore/Look.h>
 #include <MaterialXCore/Node.h>
 
+#include <mutex>
+
 MATERIALX_NAMESPACE_BEGIN
 
 class Document;
@@ -23,6 +25,11 @@ using DocumentPtr = shared_ptr<Document>;
 /// A shared pointer to a const Document
 using ConstDocumentPtr = shared_ptr<const Document>;
 
+/// A callback function reporting the duration of a version upgrade pass,
+/// given the major and minor version from which the pass upgrades and the
+/// duration of the pass in seconds.
+using UpgradeVersionCallback = std::function<void(int, int, double)>;
+
 /// @class Document
 /// A MaterialX document, which represents the top-level element in the
 /// MaterialX ownership hierarchy.
@@ -49,6 +56,7 @@ class MX_CORE_API Document : public GraphElement
     virtual DocumentPtr copy() const
     {
         DocumentPtr doc = createDocument<Document>();
+        doc->setElementPooling(getElementPooling());
         doc->copyContentFrom(getSelf());
         doc->setDataLibrary(getDataLibrary());
         return doc;
@@ -61,10 +69,7 @@ class MX_CORE_API Document : public GraphElement
     /// @{
 
     /// Store a reference to a data library in this document.
-    void setDataLibrary(ConstDocumentPtr dataLibrary)
-    {
-        _dataLibrary = dataLibrary;
-    }
+    void setDataLibrary(ConstDocumentPtr dataLibrary);
 
     /// Return true if this document has a data library.
     bool hasDataLibrary() const
@@ -78,6 +83,19 @@ class MX_CORE_API Document : public GraphElement
         return _dataLibrary;
     }
 
+    /// Freeze this document, marking its content as immutable and building
+    /// its cached lookup data in advance.  A frozen document may be shared as
+    /// the data library of any number of documents, across any number of
+    /// threads, and its lookups proceed without synchronization.  Subsequent
+    /// attempts to add, remove, or rename its elements, or to set or remove
+    /// their attributes, throw an Exception.  Values, including those set
+    /// through the typed value methods of ValueElement, are stored as
+    /// attributes and are covered by the same check.
+    void freeze();
+
+    /// Return true if this document has been frozen.
+    bool isFrozen() const;
+
     /// Import the given data library into this document.
     /// The contents of the data library are copied into this one, and
     /// are assigned the source URI of the library.
@@ -98,10 +116,16 @@ class MX_CORE_API Document : public GraphElement
         return addChild<NodeGraph>(name);
     }
 
-    /// Return the NodeGraph, if any, with the given name.
+    /// Return the NodeGraph, if any, with the given name.  If the graph has
+    /// a deferred body, then it is read before the graph is returned.
     NodeGraphPtr getNodeGraph(const string& name) const
     {
-        return getChildOfType<NodeGraph>(name);
+        NodeGraphPtr graph = getChildOfType<NodeGraph>(name);
+        if (graph)
+        {
+            graph->loadDeferredBody();
+        }
+        return graph;
     }
 
     /// Return a vector of all NodeGraph elements in the document.
@@ -621,8 +645,12 @@ class MX_CORE_API Document : public GraphElement
     std::pair<int, int> getVersionIntegers() const override;
 
     /// Upgrade the content of this document from earlier supported versions to
-    /// the library version.
-    void upgradeVersion();
+    /// the library version.  Documents at the library version are returned
+    /// unchanged without traversal.
+    /// @param callback An optional callback, which is invoked after each
+    ///    version upgrade pass with the version it upgraded from and its
+    ///    duration.
+    void upgradeVersion(const UpgradeVersionCallback& callback = nullptr);
 
     /// @}
     /// @name Color Management System
@@ -679,6 +707,14 @@ class MX_CORE_API Document : public GraphElement
     /// @return True if the document passes all tests, false otherwise.
     bool validate(string* message = nullptr) const override;
 
+    /// Validate that the given document is consistent with the MaterialX
+    /// specification, using the given validation options.
+    /// @param message An optional output string, to which a description of
+    ///    each error will be appended.
+    /// @param options Options controlling validation.
+    /// @return True if the document passes all tests, false otherwise.
+    bool validate(string* message, const ValidationOptions& options) const;
+
     /// @}
     /// @name Utility
     /// @{
@@ -686,6 +722,29 @@ class MX_CORE_API Document : public GraphElement
     /// Invalidate cached data for optimized lookups within the given document.
     void invalidateCache();
 
+    /// Set whether value elements in this document cache their parsed values,
+    /// trading memory for faster repeated calls to ValueElement::getValue.
+    /// Value caching is enabled by default, and disabling it releases all
+    /// values cached in the document.
+    void setValueCaching(bool enable);
+
+    /// Return true if value elements in this document cache their parsed values.
+    bool getValueCaching() const;
+
+    /// Set whether elements subsequently added to this document are allocated
+    /// from a pool owned by the document, reducing the cost of building and
+    /// destroying large documents.  Element pooling is disabled by default.
+    /// Elements allocated from the pool remain valid when pooling is later
+    /// disabled, and the memory of the pool is released when the last of them
+    /// is destroyed.
+    void setElementPooling(bool enable);
+
+    /// Return true if elements added to this document are allocated from a pool.
+    bool getElementPooling() const
+    {
+        return _elementPool != nullptr;
+    }
+
     /// @}
 
     //
@@ -700,12 +759,44 @@ class MX_CORE_API Document : public GraphElement
     static const string CMS_ATTRIBUTE;
     static const string CMS_CONFIG_ATTRIBUTE;
 
+  private:
+    friend class Element;
+    friend class InterfaceElement;
+    friend class Node;
+    friend class NodeGraph;
+
+    // Return the nodedef that best matches the signature of the given node.
+    NodeDefPtr matchNodeDef(const Node& node, const string& target, bool allowRoughMatch) const;
+
+    // Return a revision number for the content of this document and its data
+    // library, which increases whenever cached lookup data may be affected:
+    // on any change to the elements or attributes of either document, and
+    // when a data library is assigned.
+    size_t getRevision() const;
+
+    // Throw an exception if this document has been frozen.
+    void requireMutable() const;
+
+    // Return the mutex that guards the reading of deferred graph bodies in
+    // this document.  The mutex is recursive, so that a body may be read
+    // while another is being read on the same thread.
+    std::recursive_mutex& getDeferredBodyMutex() const;
+
+    // Notifications from the element tree, allowing cached data for optimized
+    // lookups to be updated incrementally rather than rebuilt.
+    void onAddElement(const ConstElementPtr& elem);
+    void onRemoveElement(const ConstElementPtr& elem);
+    void onRenameElement(const ConstElementPtr& elem, const string& newName);
+    void onBeginAttributeChange(const ConstElementPtr& elem);
+    void onEndAttributeChange(const ConstElementPtr& elem);
+
   private:
     class Cache;
 
   private:
     ConstDocumentPtr _dataLibrary;
     std::unique_ptr<Cache> _cache;
+    ElementPoolPtr _elementPool;
 };
 
 /// Create a new Document.
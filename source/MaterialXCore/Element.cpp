@@ -8,7 +8,10 @@
 #include <MaterialXCore/Document.h>
 #include <MaterialXCore/Util.h>
 
+#include <algorithm>
+#include <atomic>
 #include <iterator>
+#include <thread>
 
 MATERIALX_NAMESPACE_BEGIN
 
@@ -42,6 +45,266 @@ const string ValueElement::UNIFORM_ATTRIBUTE = "uniform";
 
 Element::CreatorMap Element::_creatorMap;
 
+namespace
+{
+
+// Register the attribute names above as interned strings, so that attribute
+// lookups with these constants match stored names by address.
+[[maybe_unused]] const bool ATTRIBUTE_NAMES_INTERNED = []()
+{
+    for (const string* name : { &Element::FILE_PREFIX_ATTRIBUTE, &Element::GEOM_PREFIX_ATTRIBUTE,
+                                &Element::COLOR_SPACE_ATTRIBUTE, &Element::INHERIT_ATTRIBUTE,
+                                &Element::NAMESPACE_ATTRIBUTE, &Element::DOC_ATTRIBUTE,
+                                &Element::XPOS_ATTRIBUTE, &Element::YPOS_ATTRIBUTE,
+                                &TypedElement::TYPE_ATTRIBUTE, &ValueElement::VALUE_ATTRIBUTE,
+                                &ValueElement::INTERFACE_NAME_ATTRIBUTE, &ValueElement::ENUM_ATTRIBUTE,
+                                &ValueElement::ENUM_VALUES_ATTRIBUTE, &ValueElement::UNIT_ATTRIBUTE,
+                                &ValueElement::UNITTYPE_ATTRIBUTE, &ValueElement::UNIFORM_ATTRIBUTE })
+    {
+        internStaticString(*name);
+    }
+    return true;
+}();
+
+// The validation options and state of the current thread.
+thread_local const ValidationOptions* validationOptions = nullptr;
+thread_local bool validationFailed = false;
+
+// Return true if the given attribute of the given element contributes to the
+// cached lookup data of a document.
+bool isCachedAttribute(const Element& elem, const string& attrib)
+{
+    if (attrib == PortElement::NODE_NAME_ATTRIBUTE ||
+        attrib == PortElement::NODE_GRAPH_ATTRIBUTE ||
+        attrib == NodeDef::NODE_ATTRIBUTE ||
+        attrib == InterfaceElement::NODE_DEF_ATTRIBUTE ||
+        attrib == Element::INHERIT_ATTRIBUTE)
+    {
+        return true;
+    }
+
+    // Attributes that contribute to the signatures of nodedefs.
+    if (attrib == TypedElement::TYPE_ATTRIBUTE ||
+        attrib == InterfaceElement::TARGET_ATTRIBUTE ||
+        attrib == InterfaceElement::VERSION_ATTRIBUTE ||
+        attrib == InterfaceElement::DEFAULT_VERSION_ATTRIBUTE)
+    {
+        if (elem.isA<NodeDef>())
+        {
+            return true;
+        }
+        ConstElementPtr parent = elem.getParent();
+        return parent && parent->isA<NodeDef>();
+    }
+
+    return false;
+}
+
+// Return the category shared by all instances of the given class, or the
+// empty string if its instances may have any category.
+template <class T> const string& getClassCategory()
+{
+    return EMPTY_STRING;
+}
+
+#define CLASS_CATEGORY(T)                          \
+    template <> const string& getClassCategory<T>() \
+    {                                              \
+        return T::CATEGORY;                        \
+    }
+
+CLASS_CATEGORY(AttributeDef)
+CLASS_CATEGORY(Backdrop)
+CLASS_CATEGORY(Collection)
+CLASS_CATEGORY(CommentElement)
+CLASS_CATEGORY(GeomInfo)
+CLASS_CATEGORY(GeomProp)
+CLASS_CATEGORY(GeomPropDef)
+CLASS_CATEGORY(Implementation)
+CLASS_CATEGORY(Input)
+CLASS_CATEGORY(Look)
+CLASS_CATEGORY(LookGroup)
+CLASS_CATEGORY(MaterialAssign)
+CLASS_CATEGORY(Member)
+CLASS_CATEGORY(NewlineElement)
+CLASS_CATEGORY(NodeDef)
+CLASS_CATEGORY(NodeGraph)
+CLASS_CATEGORY(Output)
+CLASS_CATEGORY(Property)
+CLASS_CATEGORY(PropertyAssign)
+CLASS_CATEGORY(PropertySet)
+CLASS_CATEGORY(PropertySetAssign)
+CLASS_CATEGORY(TargetDef)
+CLASS_CATEGORY(Token)
+CLASS_CATEGORY(TypeDef)
+CLASS_CATEGORY(Unit)
+CLASS_CATEGORY(UnitDef)
+CLASS_CATEGORY(UnitTypeDef)
+CLASS_CATEGORY(Variant)
+CLASS_CATEGORY(VariantAssign)
+CLASS_CATEGORY(VariantSet)
+CLASS_CATEGORY(Visibility)
+
+// Return the children of the given element that contribute to its content,
+// excluding comments in the manner of Element::isEquivalent.
+ElementVec getContentChildren(const ConstElementPtr& elem)
+{
+    ElementVec children;
+    children.reserve(elem->getChildren().size());
+    for (const ElementPtr& child : elem->getChildren())
+    {
+        if (child->getCategory() != CommentElement::CATEGORY)
+        {
+            children.push_back(child);
+        }
+    }
+    return children;
+}
+
+// Return true if the given elements have the same category, name and
+// attributes, ignoring attribute order.
+bool hasMatchingOwnContent(const ConstElementPtr& lhs, const ConstElementPtr& rhs)
+{
+    if (lhs->getCategory() != rhs->getCategory() || lhs->getName() != rhs->getName())
+    {
+        return false;
+    }
+    size_t attrCount = lhs->getAttributeCount();
+    if (attrCount != rhs->getAttributeCount())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < attrCount; i++)
+    {
+        const string& attrName = lhs->getAttributeName(i);
+        if (!rhs->hasAttribute(attrName) || lhs->getAttributeValue(i) != rhs->getAttribute(attrName))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Append the smallest differing subtrees of the given element trees.
+void appendElementDiffs(const ConstElementPtr& lhs, const ConstElementPtr& rhs, vector<ElementDiff>& diffs)
+{
+    if (lhs->getContentHash() == rhs->getContentHash())
+    {
+        return;
+    }
+    if (!hasMatchingOwnContent(lhs, rhs))
+    {
+        diffs.emplace_back(lhs, rhs);
+        return;
+    }
+
+    // Report the pair as a whole if their shared children are reordered.
+    ElementVec lhsChildren = getContentChildren(lhs);
+    ElementVec rhsChildren = getContentChildren(rhs);
+    auto isContentChild = [](const ElementPtr& child)
+    {
+        return child && child->getCategory() != CommentElement::CATEGORY;
+    };
+    StringVec lhsShared, rhsShared;
+    for (const ElementPtr& child : lhsChildren)
+    {
+        if (isContentChild(rhs->getChild(child->getName())))
+        {
+            lhsShared.push_back(child->getName());
+        }
+    }
+    for (const ElementPtr& child : rhsChildren)
+    {
+        if (isContentChild(lhs->getChild(child->getName())))
+        {
+            rhsShared.push_back(child->getName());
+        }
+    }
+    if (lhsShared != rhsShared)
+    {
+        diffs.emplace_back(lhs, rhs);
+        return;
+    }
+
+    // Compare children by name.
+    for (const ElementPtr& child : lhsChildren)
+    {
+        ElementPtr rhsChild = rhs->getChild(child->getName());
+        if (isContentChild(rhsChild))
+        {
+            appendElementDiffs(child, rhsChild, diffs);
+        }
+        else
+        {
+            diffs.emplace_back(child, nullptr);
+        }
+    }
+    for (const ElementPtr& child : rhsChildren)
+    {
+        if (!isContentChild(lhs->getChild(child->getName())))
+        {
+            diffs.emplace_back(nullptr, child);
+        }
+    }
+}
+
+} // anonymous namespace
+
+//
+// ElementPool methods
+//
+
+ElementPool::~ElementPool()
+{
+    for (char* chunk : _chunks)
+    {
+        ::operator delete(chunk);
+    }
+}
+
+void* ElementPool::allocate(size_t size)
+{
+    size = (size + BLOCK_ALIGNMENT - 1) & ~(BLOCK_ALIGNMENT - 1);
+    if (size > MAX_BLOCK_SIZE)
+    {
+        return ::operator new(size);
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    FreeBlock*& freeList = _freeLists[size / BLOCK_ALIGNMENT - 1];
+    if (freeList)
+    {
+        FreeBlock* block = freeList;
+        freeList = block->next;
+        return block;
+    }
+    if ((size_t) (_chunkEnd - _chunkPos) < size)
+    {
+        _chunks.push_back(static_cast<char*>(::operator new(CHUNK_SIZE)));
+        _chunkPos = _chunks.back();
+        _chunkEnd = _chunkPos + CHUNK_SIZE;
+    }
+    void* ptr = _chunkPos;
+    _chunkPos += size;
+    return ptr;
+}
+
+void ElementPool::deallocate(void* ptr, size_t size)
+{
+    size = (size + BLOCK_ALIGNMENT - 1) & ~(BLOCK_ALIGNMENT - 1);
+    if (size > MAX_BLOCK_SIZE)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    FreeBlock*& freeList = _freeLists[size / BLOCK_ALIGNMENT - 1];
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+    block->next = freeList;
+    freeList = block;
+}
+
 //
 // Element methods
 //
@@ -54,14 +317,9 @@ bool Element::operator==(const Element& rhs) const
         return false;
     }
 
-    // Compare attributes.
-    if (getAttributeNames() != rhs.getAttributeNames())
+    // Compare attributes, whose interned names may be compared by address.
+    if (_attributes != rhs._attributes)
         return false;
-    for (const string& attr : rhs.getAttributeNames())
-    {
-        if (getAttribute(attr) != rhs.getAttribute(attr))
-            return false;
-    }
 
     // Compare children.
     const ElementVec& c1 = getChildren();
@@ -81,6 +339,35 @@ bool Element::operator!=(const Element& rhs) const
     return !(*this == rhs);
 }
 
+void Element::setCategory(const string& category)
+{
+    if (category == _category)
+    {
+        return;
+    }
+    DocumentPtr doc = getDocument();
+    doc->requireMutable();
+
+    // Update the category index of the parent, if this element is registered.
+    // Document lookup data is updated for this element alone, as for an
+    // attribute change.
+    ElementPtr parent = getParent();
+    if (parent && parent->getChild(_name) == getSelf())
+    {
+        doc->onBeginAttributeChange(getSelf());
+        const string previous = std::move(_category);
+        _category = category;
+        parent->removeChildCategoryIndex(getSelf(), previous);
+        parent->addChildCategoryIndex(getSelf());
+        doc->onEndAttributeChange(getSelf());
+    }
+    else
+    {
+        _category = category;
+    }
+    invalidateContentHash();
+}
+
 void Element::setName(const string& name)
 {
     ElementPtr parent = getParent();
@@ -89,7 +376,7 @@ void Element::setName(const string& name)
         throw Exception("Element name is not unique at the given scope: " + name);
     }
 
-    getDocument()->invalidateCache();
+    getDocument()->onRenameElement(getSelf(), name);
 
     if (parent)
     {
@@ -97,6 +384,7 @@ void Element::setName(const string& name)
         parent->_childMap[name] = getSelf();
     }
     _name = name;
+    invalidateContentHash();
 }
 
 string Element::getNamePath(ConstElementPtr relativeTo) const
@@ -135,19 +423,94 @@ ElementPtr Element::getDescendant(const string& namePath) const
 
 void Element::registerChildElement(ElementPtr child)
 {
-    getDocument()->invalidateCache();
+    DocumentPtr doc = getDocument();
+    doc->requireMutable();
 
     _childMap[child->getName()] = child;
     _childOrder.push_back(child);
+    addChildCategoryIndex(child);
+    invalidateContentHash();
+
+    doc->onAddElement(child);
 }
 
 void Element::unregisterChildElement(ElementPtr child)
 {
-    getDocument()->invalidateCache();
+    getDocument()->onRemoveElement(child);
 
     _childMap.erase(child->getName());
     _childOrder.erase(
         std::find(_childOrder.begin(), _childOrder.end(), child));
+    invalidateContentHash();
+    removeChildCategoryIndex(child, child->getCategory());
+}
+
+const std::unordered_map<string, ElementVec>& Element::getChildCategoryMap() const
+{
+    requireChildren();
+    std::unordered_map<string, ElementVec>* categoryMap = _childCategoryMap.load(std::memory_order_acquire);
+    if (categoryMap)
+    {
+        return *categoryMap;
+    }
+
+    std::unique_ptr<std::unordered_map<string, ElementVec>> newMap(new std::unordered_map<string, ElementVec>());
+    for (const ElementPtr& child : _childOrder)
+    {
+        (*newMap)[child->getCategory()].push_back(child);
+    }
+    if (_childCategoryMap.compare_exchange_strong(categoryMap, newMap.get(), std::memory_order_acq_rel))
+    {
+        categoryMap = newMap.release();
+    }
+    return *categoryMap;
+}
+
+void Element::addChildCategoryIndex(ElementPtr child)
+{
+    std::unordered_map<string, ElementVec>* categoryMap = _childCategoryMap.load();
+    if (!categoryMap)
+    {
+        return;
+    }
+
+    // Count the children of the same category that follow the given child.
+    // Children are most often added at the end, in which case no others are
+    // visited.
+    size_t following = 0;
+    for (auto it = _childOrder.rbegin(); it != _childOrder.rend() && *it != child; ++it)
+    {
+        if ((*it)->_category == child->_category)
+        {
+            following++;
+        }
+    }
+    ElementVec& categoryChildren = (*categoryMap)[child->getCategory()];
+    categoryChildren.insert(categoryChildren.end() - (std::ptrdiff_t) following, child);
+}
+
+void Element::removeChildCategoryIndex(ElementPtr child, const string& category)
+{
+    std::unordered_map<string, ElementVec>* categoryMap = _childCategoryMap.load();
+    if (!categoryMap)
+    {
+        return;
+    }
+
+    auto it = categoryMap->find(category);
+    if (it != categoryMap->end())
+    {
+        ElementVec& categoryChildren = it->second;
+        auto childIt = std::find(categoryChildren.begin(), categoryChildren.end(), child);
+        if (childIt != categoryChildren.end())
+        {
+            categoryChildren.erase(childIt);
+        }
+        if (categoryChildren.empty())
+        {
+            categoryMap->erase(it);
+        }
+    }
 }
 
 int Element::getChildIndex(const string& name) const
@@ -175,12 +538,32 @@ void Element::setChildIndex(const string& name, int index)
         throw Exception("Invalid child index");
     }
 
+    if (std::distance(_childOrder.begin(), it) == index)
+    {
+        return;
+    }
+
+    getDocument()->invalidateCache();
+
     _childOrder.erase(it);
     _childOrder.insert(_childOrder.begin() + (size_t) index, child);
+    removeChildCategoryIndex(child, child->getCategory());
+    addChildCategoryIndex(child);
+    invalidateContentHash();
+}
+
+void Element::readDeferredChildren() const
+{
+    ConstNodeGraphPtr graph = asA<NodeGraph>();
+    if (graph)
+    {
+        graph->loadDeferredBody();
+    }
 }
 
 void Element::removeChild(const string& name)
 {
+    requireChildren();
     ElementMap::iterator it = _childMap.find(name);
     if (it == _childMap.end())
     {
@@ -192,25 +575,63 @@ void Element::removeChild(const string& name)
 
 void Element::setAttribute(const string& attrib, const string& value)
 {
-    getDocument()->invalidateCache();
+    DocumentPtr doc = getDocument();
+    doc->requireMutable();
+    const bool isCached = isCachedAttribute(*this, attrib);
+    if (isCached)
+    {
+        doc->onBeginAttributeChange(getSelf());
+    }
+    else if (attrib == NAMESPACE_ATTRIBUTE)
+    {
+        doc->invalidateCache();
+    }
 
-    if (!_attributeMap.count(attrib))
+    AttributeVec::const_iterator it = findAttribute(attrib);
+    if (it != _attributes.end())
     {
-        _attributeOrder.push_back(attrib);
+        _attributes[it - _attributes.begin()].second = value;
+    }
+    else
+    {
+        _attributes.emplace_back(&internString(attrib), value);
+        _attributeNames.push_back(attrib);
+    }
+    onAttributeChange(attrib);
+    invalidateContentHash();
+
+    if (isCached)
+    {
+        doc->onEndAttributeChange(getSelf());
     }
-    _attributeMap[attrib] = value;
 }
 
 void Element::removeAttribute(const string& attrib)
 {
-    StringMap::iterator it = _attributeMap.find(attrib);
-    if (it != _attributeMap.end())
+    AttributeVec::const_iterator it = findAttribute(attrib);
+    if (it != _attributes.end())
     {
-        getDocument()->invalidateCache();
+        DocumentPtr doc = getDocument();
+        doc->requireMutable();
+        const bool isCached = isCachedAttribute(*this, attrib);
+        if (isCached)
+        {
+            doc->onBeginAttributeChange(getSelf());
+        }
+        else if (attrib == NAMESPACE_ATTRIBUTE)
+        {
+            doc->invalidateCache();
+        }
 
-        _attributeMap.erase(it);
-        _attributeOrder.erase(
-            std::find(_attributeOrder.begin(), _attributeOrder.end(), attrib));
+        _attributeNames.erase(_attributeNames.begin() + (it - _attributes.begin()));
+        _attributes.erase(it);
+        onAttributeChange(attrib);
+        invalidateContentHash();
+
+        if (isCached)
+        {
+            doc->onEndAttributeChange(getSelf());
+        }
     }
 }
 
@@ -226,6 +647,7 @@ template <class T> shared_ptr<const T> Element::asA() const
 
 ElementPtr Element::addChildOfCategory(const string& category, string name)
 {
+    requireChildren();
     if (name.empty())
     {
         name = createValidChildName(category + "1");
@@ -295,19 +717,41 @@ template <class T> shared_ptr<T> Element::getChildOfType(const string& name) con
 
 template <class T> vector<shared_ptr<T>> Element::getChildrenOfType(const string& category) const
 {
+    requireChildren();
     vector<shared_ptr<T>> children;
     ConstDocumentPtr doc = asA<Document>();
     if (doc && doc->hasDataLibrary())
     {
         children = doc->getDataLibrary()->getChildrenOfType<T>(category);
     }
+
+    // Use the category index when a category is given, or when all instances
+    // of the requested class share a single category.
+    const string& indexCategory = category.empty() ? getClassCategory<T>() : category;
+    if (!indexCategory.empty())
+    {
+        const std::unordered_map<string, ElementVec>& categoryMap = getChildCategoryMap();
+        auto it = categoryMap.find(indexCategory);
+        if (it != categoryMap.end())
+        {
+            children.reserve(children.size() + it->second.size());
+            for (const ElementPtr& child : it->second)
+            {
+                shared_ptr<T> instance = child->asA<T>();
+                if (instance)
+                {
+                    children.push_back(instance);
+                }
+            }
+        }
+        return children;
+    }
+
     for (ElementPtr child : _childOrder)
     {
         shared_ptr<T> instance = child->asA<T>();
         if (!instance)
             continue;
-        if (!category.empty() && child->getCategory() != category)
-            continue;
         children.push_back(instance);
     }
     return children;
@@ -344,6 +788,12 @@ ConstDocumentPtr Element::getDocument() const
     return getRoot()->asA<Document>();
 }
 
+ElementPoolPtr Element::getElementPool() const
+{
+    ConstDocumentPtr doc = getDocument();
+    return doc ? doc->_elementPool : nullptr;
+}
+
 bool Element::hasInheritedBase(ConstElementPtr base) const
 {
     for (ConstElementPtr elem : traverseInheritance())
@@ -388,27 +838,35 @@ bool Element::isEquivalent(ConstElementPtr rhs, const ElementEquivalenceOptions&
         return false;
     }
 
-    // Compare attribute names. 
-    StringVec attributeNames = getAttributeNames();
-    StringVec rhsAttributeNames = rhs->getAttributeNames();
-
-    // Filter out any attributes specified in the options.
+    // Compare attribute names, ignoring their ordering and any attributes
+    // specified in the options.  Since names are unique within an element,
+    // the sets of names match if their sizes match and one contains the other.
     const StringSet& attributeExclusionList = options.attributeExclusionList;
-    if (!attributeExclusionList.empty())
+    auto isCompared = [&attributeExclusionList](const string& attr)
     {
-        attributeNames.erase(std::remove_if(attributeNames.begin(), attributeNames.end(),
-            [&attributeExclusionList](const string& attr) { return attributeExclusionList.find(attr) != attributeExclusionList.end(); }),
-            attributeNames.end());
-        rhsAttributeNames.erase(std::remove_if(rhsAttributeNames.begin(), rhsAttributeNames.end(),
-            [&attributeExclusionList](const string& attr) { return attributeExclusionList.find(attr) != attributeExclusionList.end(); }),
-            rhsAttributeNames.end());
-    }    
-
-    // Ignore attribute ordering by sorting names
-    std::sort(attributeNames.begin(), attributeNames.end());
-    std::sort(rhsAttributeNames.begin(), rhsAttributeNames.end());
+        return attributeExclusionList.find(attr) == attributeExclusionList.end();
+    };
+    bool namesMatch = true;
+    size_t attributeCount = 0;
+    for (size_t i = 0; i < getAttributeCount(); i++)
+    {
+        const string& attr = getAttributeName(i);
+        if (isCompared(attr))
+        {
+            attributeCount++;
+            namesMatch = namesMatch && rhs->hasAttribute(attr);
+        }
+    }
+    size_t rhsAttributeCount = 0;
+    for (size_t i = 0; i < rhs->getAttributeCount(); i++)
+    {
+        if (isCompared(rhs->getAttributeName(i)))
+        {
+            rhsAttributeCount++;
+        }
+    }
 
-    if (attributeNames != rhsAttributeNames)
+    if (!namesMatch || attributeCount != rhsAttributeCount)
     {
         if (message)
         {
@@ -417,9 +875,10 @@ bool Element::isEquivalent(ConstElementPtr rhs, const ElementEquivalenceOptions&
         return false;
     }
 
-    for (const string& attr : rhsAttributeNames)
+    for (size_t i = 0; i < rhs->getAttributeCount(); i++)
     {
-        if (!isAttributeEquivalent(rhs, attr, options, message))
+        const string& attr = rhs->getAttributeName(i);
+        if (isCompared(attr) && !isAttributeEquivalent(rhs, attr, options, message))
         {
             return false;
         }
@@ -497,6 +956,66 @@ bool Element::isAttributeEquivalent(ConstElementPtr rhs, const string& attribute
     return true;
 }
 
+size_t Element::getContentHash() const
+{
+    requireChildren();
+    size_t hash = _contentHash.load(std::memory_order_acquire);
+    if (hash)
+    {
+        return hash;
+    }
+
+    hash = 0;
+    hashCombine(hash, _category);
+    hashCombine(hash, _name);
+    size_t attrHash = 0;
+    for (const auto& attr : _attributes)
+    {
+        size_t pairHash = 0;
+        hashCombine(pairHash, *attr.first);
+        hashCombine(pairHash, attr.second);
+        attrHash += pairHash;
+    }
+    hashCombine(hash, attrHash);
+    for (const ElementPtr& child : _childOrder)
+    {
+        if (child->getCategory() != CommentElement::CATEGORY)
+        {
+            hashCombine(hash, child->getContentHash());
+        }
+    }
+
+    // Zero is reserved to denote an invalid hash.
+    if (!hash)
+    {
+        hash = 1;
+    }
+    _contentHash.store(hash, std::memory_order_release);
+    return hash;
+}
+
+vector<ElementDiff> Element::diff(ConstElementPtr rhs) const
+{
+    vector<ElementDiff> diffs;
+    appendElementDiffs(getSelf(), rhs, diffs);
+    return diffs;
+}
+
+void Element::invalidateContentHash()
+{
+    if (!_contentHash.exchange(0, std::memory_order_acq_rel))
+    {
+        return;
+    }
+    for (ElementPtr parent = getParent(); parent; parent = parent->getParent())
+    {
+        if (!parent->_contentHash.exchange(0, std::memory_order_acq_rel))
+        {
+            break;
+        }
+    }
+}
+
 TreeIterator Element::traverseTree() const
 {
     return TreeIterator(getSelfNonConst());
@@ -524,11 +1043,34 @@ InheritanceIterator Element::traverseInheritance() const
 
 void Element::copyContentFrom(const ConstElementPtr& source)
 {
-    getDocument()->invalidateCache();
+    DocumentPtr doc = getDocument();
+    if (getNamespace() != source->getNamespace())
+    {
+        doc->invalidateCache();
+    }
+    doc->onBeginAttributeChange(getSelf());
 
     _sourceUri = source->_sourceUri;
-    _attributeMap = source->_attributeMap;
-    _attributeOrder = source->_attributeOrder;
+    _attributes = source->_attributes;
+    _attributeNames = source->_attributeNames;
+    onAttributeChange(EMPTY_STRING);
+    invalidateContentHash();
+
+    doc->onEndAttributeChange(getSelf());
+
+    // Carry a deferred graph body over to a graph without children, to be
+    // read on demand.  The body is otherwise read before it is copied.
+    if (source->_hasDeferredBody && !_hasDeferredBody && _childOrder.empty())
+    {
+        ConstNodeGraphPtr sourceGraph = source->asA<NodeGraph>();
+        NodeGraphPtr graph = asA<NodeGraph>();
+        NodeGraphBodyLoader loader = sourceGraph ? sourceGraph->getDeferredBody() : nullptr;
+        if (graph && loader)
+        {
+            graph->setDeferredBody(loader);
+            return;
+        }
+    }
 
     for (auto child : source->getChildren())
     {
@@ -549,13 +1091,35 @@ void Element::copyContentFrom(const ConstElementPtr& source)
 
 void Element::clearContent()
 {
-    getDocument()->invalidateCache();
+    // Discard any deferred children, which would otherwise be read on the
+    // next access.
+    if (_hasDeferredBody)
+    {
+        asA<NodeGraph>()->setDeferredBody(nullptr);
+    }
+
+    DocumentPtr doc = getDocument();
+    if (doc == getSelf())
+    {
+        doc->invalidateCache();
+    }
+    else
+    {
+        if (hasNamespace())
+        {
+            doc->invalidateCache();
+        }
+        doc->onRemoveElement(getSelf());
+    }
 
     _sourceUri.clear();
-    _attributeMap.clear();
-    _attributeOrder.clear();
+    _attributes.clear();
+    _attributeNames.clear();
+    onAttributeChange(EMPTY_STRING);
+    invalidateContentHash();
     _childMap.clear();
     _childOrder.clear();
+    delete _childCategoryMap.exchange(nullptr);
 }
 
 bool Element::validate(string* message) const
@@ -567,10 +1131,7 @@ bool Element::validate(string* message) const
         bool validInherit = getInheritsFrom() && getInheritsFrom()->getCategory() == getCategory();
         validateRequire(validInherit, res, message, "Invalid element inheritance");
     }
-    for (auto child : getChildren())
-    {
-        res = child->validate(message) && res;
-    }
+    res = validateChildren(message) && res;
     validateRequire(!hasInheritanceCycle(), res, message, "Cycle in element inheritance chain");
     return res;
 }
@@ -612,9 +1173,9 @@ string Element::asString() const
     {
         res += " name=\"" + getName() + "\"";
     }
-    for (const string& attrName : getAttributeNames())
+    for (const auto& attr : _attributes)
     {
-        res += " " + attrName + "=\"" + getAttribute(attrName) + "\"";
+        res += " " + *attr.first + "=\"" + attr.second + "\"";
     }
     res += ">";
     return res;
@@ -625,6 +1186,11 @@ void Element::validateRequire(bool expression, bool& res, string* message, const
     if (!expression)
     {
         res = false;
+        if (validationOptions && validationOptions->firstErrorOnly && validationFailed)
+        {
+            return;
+        }
+        validationFailed = true;
         if (message)
         {
             *message += errorDesc + ": " + asString() + "\n";
@@ -632,6 +1198,130 @@ void Element::validateRequire(bool expression, bool& res, string* message, const
     }
 }
 
+bool Element::validateChildren(string* message) const
+{
+    const ElementVec& children = getChildren();
+    const bool firstErrorOnly = validationOptions && validationOptions->firstErrorOnly;
+    unsigned int threadCount = validationOptions ? validationOptions->threadCount : 1;
+    if (threadCount == 0)
+    {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    // Validate children serially, other than the top-level elements of a
+    // document.
+    bool res = true;
+    if (threadCount == 1 || getParent() || children.size() < 2)
+    {
+        for (const ElementPtr& child : children)
+        {
+            if (firstErrorOnly && validationFailed)
+            {
+                break;
+            }
+            res = child->validate(message) && res;
+        }
+        return res;
+    }
+    if (firstErrorOnly && validationFailed)
+    {
+        return res;
+    }
+
+    // Read any deferred graph bodies before the workers are started, since
+    // reading a body modifies the document.
+    for (const ElementPtr& child : children)
+    {
+        if (NodeGraphPtr graph = child->asA<NodeGraph>())
+        {
+            graph->loadDeferredBody();
+        }
+    }
+
+    // Validate each top-level element independently across worker threads,
+    // skipping elements that follow a failure when only the first error is
+    // required.
+    ValidationOptions workerOptions = *validationOptions;
+    workerOptions.threadCount = 1;
+    vector<string> messages(children.size());
+    std::unique_ptr<bool[]> results(new bool[children.size()]);
+    std::atomic<size_t> nextIndex(0);
+    std::atomic<size_t> firstFailure(children.size());
+    vector<std::exception_ptr> exceptions(std::min<size_t>(threadCount, children.size()));
+    vector<std::thread> workers;
+    for (size_t w = 0; w < exceptions.size(); w++)
+    {
+        workers.emplace_back([&, w]()
+        {
+            try
+            {
+                for (size_t i = nextIndex++; i < children.size(); i = nextIndex++)
+                {
+                    results[i] = true;
+                    if (firstErrorOnly && i > firstFailure)
+                    {
+                        continue;
+                    }
+                    ValidationScope scope(workerOptions);
+                    results[i] = children[i]->validate(message ? &messages[i] : nullptr);
+                    size_t failure = firstFailure;
+                    while (!results[i] && i < failure && !firstFailure.compare_exchange_weak(failure, i))
+                    {
+                    }
+                }
+            }
+            catch (...)
+            {
+                exceptions[w] = std::current_exception();
+            }
+        });
+    }
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+    for (const std::exception_ptr& exception : exceptions)
+    {
+        if (exception)
+        {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    // Merge results in the order of the children.
+    for (size_t i = 0; i < children.size(); i++)
+    {
+        if (message)
+        {
+            *message += messages[i];
+        }
+        if (!results[i])
+        {
+            res = false;
+            validationFailed = true;
+            if (firstErrorOnly)
+            {
+                break;
+            }
+        }
+    }
+    return res;
+}
+
+Element::ValidationScope::ValidationScope(const ValidationOptions& options) :
+    _previousOptions(validationOptions),
+    _previousFailed(validationFailed)
+{
+    validationOptions = &options;
+    validationFailed = false;
+}
+
+Element::ValidationScope::~ValidationScope()
+{
+    validationOptions = _previousOptions;
+    validationFailed = _previousFailed;
+}
+
 //
 // TypedElement methods
 //
@@ -660,14 +1350,34 @@ string ValueElement::getResolvedValueString(StringResolverPtr resolver) const
 
 ValuePtr ValueElement::getValue() const
 {
-    if (!hasValue())
-        return ValuePtr();
+    ConstValuePtr value = getConstValue();
+    return value ? value->copy() : ValuePtr();
+}
 
-    return Value::createValueFromStrings(getValueString(), getType(), getDocument()->getTypeDef(getType()));
+ConstValuePtr ValueElement::getConstValue() const
+{
+    ConstValuePtr cached = std::atomic_load(&_cachedValue);
+    if (cached || !hasValue())
+        return cached;
+
+    // Cache values of registered types, whose parsing is independent of the
+    // typedefs in the document.  Aggregate values are parsed against the
+    // typedef of their struct type, which may change without notice to
+    // this element.
+    ConstDocumentPtr doc = getDocument();
+    ConstValuePtr value = Value::createValueFromStrings(getValueString(), getType(), doc->getTypeDef(getType()));
+    if (value && value->getTypeString() == getType() &&
+        !value->isA<AggregateValue>() && doc->getValueCaching())
+    {
+        std::atomic_store(&_cachedValue, value);
+    }
+    return value;
 }
 
 ValuePtr ValueElement::getResolvedValue(StringResolverPtr resolver) const
 {
+    if (!StringResolver::isResolvedType(getType()))
+        return getValue();
     if (!hasValue())
         return ValuePtr();
 
@@ -693,6 +1403,14 @@ ValuePtr ValueElement::getDefaultValue() const
     return ValuePtr();
 }
 
+void ValueElement::onAttributeChange(const string& attrib)
+{
+    if (attrib.empty() || attrib == VALUE_ATTRIBUTE || attrib == TYPE_ATTRIBUTE)
+    {
+        std::atomic_store(&_cachedValue, ConstValuePtr());
+    }
+}
+
 const string& ValueElement::getActiveUnit() const
 {
     // Return the unit, if any, stored in our declaration.
@@ -734,8 +1452,8 @@ bool ValueElement::isAttributeEquivalent(ConstElementPtr rhs, const string& attr
         ConstValueElementPtr rhsValueElement = rhs->asA<ValueElement>();
         if (rhsValueElement && attributeName == ValueElement::VALUE_ATTRIBUTE)
         {
-            ValuePtr thisValue = getValue();
-            ValuePtr rhsValue = rhsValueElement->getValue();
+            ConstValuePtr thisValue = getConstValue();
+            ConstValuePtr rhsValue = rhsValueElement->getConstValue();
             if (thisValue && rhsValue)
             {
                 if (thisValue->getValueString() != rhsValue->getValueString())
@@ -787,7 +1505,7 @@ bool ValueElement::validate(string* message) const
     bool res = true;
     if (hasType() && hasValueString())
     {
-        validateRequire(getValue() != nullptr, res, message, "Invalid value");
+        validateRequire(getConstValue() != nullptr, res, message, "Invalid value");
     }
 
     if (hasInterfaceName())
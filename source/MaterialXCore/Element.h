@@ -15,6 +15,9 @@
 #include <MaterialXCore/Util.h>
 #include <MaterialXCore/Value.h>
 
+#include <atomic>
+#include <mutex>
+
 MATERIALX_NAMESPACE_BEGIN
 
 class Element;
@@ -26,6 +29,7 @@ class NewlineElement;
 class GenericElement;
 class StringResolver;
 class Document;
+class ValidationOptions;
 
 /// A shared pointer to an Element
 using ElementPtr = shared_ptr<Element>;
@@ -74,7 +78,102 @@ using ElementMap = std::unordered_map<string, ElementPtr>;
 /// A standard function taking an ElementPtr and returning a boolean.
 using ElementPredicate = std::function<bool(ConstElementPtr)>;
 
+/// A pair of corresponding elements whose content differs between two element
+/// trees.  A null first element denotes an added element, and a null second
+/// element denotes a removed element.
+using ElementDiff = std::pair<ConstElementPtr, ConstElementPtr>;
+
 class ElementEquivalenceOptions;
+class ElementPool;
+
+/// A shared pointer to an ElementPool
+using ElementPoolPtr = shared_ptr<ElementPool>;
+
+/// @class ElementPool
+/// A pool from which the elements of a document are allocated, when element
+/// pooling is enabled through Document::setElementPooling.
+///
+/// Each element is allocated together with its reference counts from large
+/// shared chunks, and released blocks are recycled by size.  The chunks of
+/// the pool are returned to the system together when the last element
+/// allocated from the pool is destroyed.
+class MX_CORE_API ElementPool
+{
+  public:
+    ElementPool() = default;
+    ~ElementPool();
+
+    ElementPool(const ElementPool&) = delete;
+    ElementPool& operator=(const ElementPool&) = delete;
+
+    /// Allocate a block of memory with the given size in bytes.
+    void* allocate(size_t size);
+
+    /// Return a block of memory with the given size in bytes to the pool.
+    void deallocate(void* ptr, size_t size);
+
+  private:
+    static const size_t BLOCK_ALIGNMENT = 16;
+    static const size_t MAX_BLOCK_SIZE = 1024;
+    static const size_t CHUNK_SIZE = 64 * 1024;
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+  private:
+    std::mutex _mutex;
+    vector<char*> _chunks;
+    char* _chunkPos = nullptr;
+    char* _chunkEnd = nullptr;
+    std::array<FreeBlock*, MAX_BLOCK_SIZE / BLOCK_ALIGNMENT> _freeLists = {};
+};
+
+/// @class ElementPoolAllocator
+/// A standard allocator that draws from an ElementPool, keeping the pool
+/// alive for as long as any of its allocations remain.
+template <class T> class ElementPoolAllocator
+{
+  public:
+    using value_type = T;
+
+    explicit ElementPoolAllocator(ElementPoolPtr pool) :
+        _pool(std::move(pool))
+    {
+    }
+    template <class U> ElementPoolAllocator(const ElementPoolAllocator<U>& other) :
+        _pool(other.getPool())
+    {
+    }
+
+    T* allocate(size_t count)
+    {
+        return static_cast<T*>(_pool->allocate(count * sizeof(T)));
+    }
+    void deallocate(T* ptr, size_t count)
+    {
+        _pool->deallocate(ptr, count * sizeof(T));
+    }
+
+    /// Return the pool of this allocator.
+    const ElementPoolPtr& getPool() const
+    {
+        return _pool;
+    }
+
+    template <class U> bool operator==(const ElementPoolAllocator<U>& rhs) const
+    {
+        return _pool == rhs.getPool();
+    }
+    template <class U> bool operator!=(const ElementPoolAllocator<U>& rhs) const
+    {
+        return _pool != rhs.getPool();
+    }
+
+  private:
+    ElementPoolPtr _pool;
+};
 
 /// @class Element
 /// The base class for MaterialX elements.
@@ -88,12 +187,18 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
         _category(category),
         _name(name),
         _parent(parent),
-        _root(parent ? parent->getRoot() : nullptr)
+        _root(parent ? parent->getRoot() : nullptr),
+        _childCategoryMap(nullptr),
+        _hasDeferredBody(false),
+        _contentHash(0)
     {
     }
 
   public:
-    virtual ~Element() { }
+    virtual ~Element()
+    {
+        delete _childCategoryMap.load();
+    }
     Element(const Element&) = delete;
     Element& operator=(const Element&) = delete;
 
@@ -116,10 +221,7 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     /// @{
 
     /// Set the element's category string.
-    void setCategory(const string& category)
-    {
-        _category = category;
-    }
+    void setCategory(const string& category);
 
     /// Return the element's category string.  The category of a MaterialX
     /// element represents its role within the document, with common examples
@@ -433,6 +535,7 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     /// Return the child element, if any, with the given name.
     ElementPtr getChild(const string& name) const
     {
+        requireChildren();
         ElementMap::const_iterator it = _childMap.find(name);
         return (it != _childMap.end()) ? it->second : ElementPtr();
     }
@@ -446,6 +549,7 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     /// The returned vector maintains the order in which children were added.
     const ElementVec& getChildren() const
     {
+        requireChildren();
         return _childOrder;
     }
 
@@ -484,21 +588,41 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     /// Return true if the given attribute is present.
     bool hasAttribute(const string& attrib) const
     {
-        return _attributeMap.count(attrib) != 0;
+        return findAttribute(attrib) != _attributes.end();
     }
 
     /// Return the value string of the given attribute.  If the given attribute
     /// is not present, then an empty string is returned.
     const string& getAttribute(const string& attrib) const
     {
-        StringMap::const_iterator it = _attributeMap.find(attrib);
-        return (it != _attributeMap.end()) ? it->second : EMPTY_STRING;
+        AttributeVec::const_iterator it = findAttribute(attrib);
+        return (it != _attributes.end()) ? it->second : EMPTY_STRING;
     }
 
     /// Return a vector of stored attribute names, in the order they were set.
     const StringVec& getAttributeNames() const
     {
-        return _attributeOrder;
+        return _attributeNames;
+    }
+
+    /// Return the number of stored attributes.
+    size_t getAttributeCount() const
+    {
+        return _attributes.size();
+    }
+
+    /// Return the name of the stored attribute at the given index, in the
+    /// order they were set.  Together with getAttributeValue, this allows
+    /// attributes to be visited without allocating a vector of names.
+    const string& getAttributeName(size_t index) const
+    {
+        return *_attributes[index].first;
+    }
+
+    /// Return the value string of the stored attribute at the given index.
+    const string& getAttributeValue(size_t index) const
+    {
+        return _attributes[index].second;
     }
 
     /// Set the value of an implicitly typed attribute.  Since an attribute
@@ -625,6 +749,31 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
                                        const ElementEquivalenceOptions& options, 
                                        string* message = nullptr) const;
 
+    /// @}
+    /// @name Content Hashing
+    /// @{
+
+    /// Return a hash of the content of this element tree, combining the
+    /// category, name and attributes of each element with the hashes of its
+    /// children in order.  Attribute order and comment elements are ignored,
+    /// matching the criteria of isEquivalent with exact value comparisons.
+    ///
+    /// Hashes are computed on demand and cached, and any edit to an element
+    /// invalidates the cached hashes of the element and its ancestors, so
+    /// repeated calls on a modified tree only rehash the edited branches.
+    size_t getContentHash() const;
+
+    /// Return the smallest subtrees whose content differs between this
+    /// element tree and the given one.  Children are matched by name, and
+    /// subtrees with equal content hashes are skipped without comparison.
+    /// @param rhs Element tree to compare against
+    /// @return A vector of pairs, each holding an element from this tree and
+    ///    its counterpart in the given tree.  Elements whose own category,
+    ///    name or attributes differ, or whose matching children are in a
+    ///    different order, are reported as a whole.  Elements present in only
+    ///    one tree are paired with a null element.
+    vector<ElementDiff> diff(ConstElementPtr rhs) const;
+
     /// @}
     /// @name Traversal
     /// @{
@@ -769,10 +918,21 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     /// Clear all attributes and descendants from this element.
     virtual void clearContent();
 
+    /// Reserve storage for the given number of additional child elements and
+    /// attributes.  This is an optional optimization for clients that build
+    /// elements in bulk, such as readers of serialized documents.
+    void reserveContent(size_t childCount, size_t attributeCount)
+    {
+        _childMap.reserve(_childMap.size() + childCount);
+        _childOrder.reserve(_childOrder.size() + childCount);
+        _attributes.reserve(_attributes.size() + attributeCount);
+    }
+
     /// Using the input name as a starting point, modify it to create a valid,
     /// unique name for a child element.
     string createValidChildName(string name) const
     {
+        requireChildren();
         name = name.empty() ? "_" : createValidName(name);
         while (_childMap.count(name))
         {
@@ -812,6 +972,23 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     // state and optional output text if the requirement is not met.
     void validateRequire(bool expression, bool& res, string* message, const string& errorDesc) const;
 
+    // Validate the children of this element, appending their messages in
+    // the order of the children.
+    bool validateChildren(string* message) const;
+
+    // A scope within which validation on the current thread follows the
+    // given options.
+    class ValidationScope
+    {
+      public:
+        explicit ValidationScope(const ValidationOptions& options);
+        ~ValidationScope();
+
+      private:
+        const ValidationOptions* _previousOptions;
+        bool _previousFailed;
+    };
+
   public:
     static const string NAME_ATTRIBUTE;
     static const string FILE_PREFIX_ATTRIBUTE;
@@ -827,6 +1004,37 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     virtual void registerChildElement(ElementPtr child);
     virtual void unregisterChildElement(ElementPtr child);
 
+    // Return the index of child elements by category, building it on first
+    // use.  Concurrent readers may race to build the index, in which case
+    // all but one of the results are discarded.
+    const std::unordered_map<string, ElementVec>& getChildCategoryMap() const;
+
+    // Add the given child to the category index, if it has been built,
+    // preserving document order within its category.
+    void addChildCategoryIndex(ElementPtr child);
+
+    // Remove the given child from the category index, if it has been built,
+    // where the child was last indexed under the given category.
+    void removeChildCategoryIndex(ElementPtr child, const string& category);
+
+    // Discard any data derived from the given attribute, or from all
+    // attributes if the given name is empty.
+    virtual void onAttributeChange(const string&) { }
+
+    // Discard the cached content hashes of this element and its ancestors.
+    void invalidateContentHash();
+
+    // Read the deferred child elements of this element, if any, before its
+    // children are accessed.  Only graph elements have deferred children.
+    void requireChildren() const
+    {
+        if (_hasDeferredBody.load(std::memory_order_acquire))
+        {
+            readDeferredChildren();
+        }
+    }
+    void readDeferredChildren() const;
+
     // Return a non-const copy of our self pointer, for use in constructing
     // graph traversal objects that require non-const storage.
     ElementPtr getSelfNonConst() const
@@ -834,6 +1042,25 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
         return std::const_pointer_cast<Element>(shared_from_this());
     }
 
+  protected:
+    // Attribute names are interned strings, stored with their values in the
+    // order they were set.  Elements hold few attributes, so a linear search
+    // is faster than a hashed lookup.
+    using AttributeVec = vector<std::pair<const string*, string>>;
+
+    // Return the stored attribute with the given name.  Names are compared
+    // by address before value, so that lookups with the standard attribute
+    // name constants, which are registered as interned strings, match
+    // without comparing characters.
+    AttributeVec::const_iterator findAttribute(const string& attrib) const
+    {
+        return std::find_if(_attributes.begin(), _attributes.end(),
+                            [&attrib](const AttributeVec::value_type& attr)
+                            {
+                                return attr.first == &attrib || *attr.first == attrib;
+                            });
+    }
+
   protected:
     string _category;
     string _name;
@@ -842,18 +1069,46 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     ElementMap _childMap;
     ElementVec _childOrder;
 
-    StringMap _attributeMap;
-    StringVec _attributeOrder;
+    // The stored attributes, and their names in the same order, which are
+    // returned by reference from getAttributeNames.
+    AttributeVec _attributes;
+    StringVec _attributeNames;
 
     weak_ptr<Element> _parent;
     weak_ptr<Element> _root;
 
+    // The index of child elements by category, or null if it has not yet
+    // been built.  The index is built when children are first queried by
+    // category, and is then updated as children are added and removed.
+    mutable std::atomic<std::unordered_map<string, ElementVec>*> _childCategoryMap;
+
+    // True if the child elements of this element have been deferred, and
+    // are read on first access.
+    mutable std::atomic<bool> _hasDeferredBody;
+
+    // The cached content hash of this element tree, or zero if invalid.  An
+    // invalid hash implies that the hashes of all ancestors are invalid.
+    mutable std::atomic<size_t> _contentHash;
+
   private:
-    template <class T> static ElementPtr createElement(ElementPtr parent, const string& name)
+    // Return the element pool of the document, if pooling is enabled.
+    ElementPoolPtr getElementPool() const;
+
+    template <class T> static shared_ptr<T> allocateElement(ElementPtr parent, const string& name)
     {
+        ElementPoolPtr pool = parent ? parent->getElementPool() : nullptr;
+        if (pool)
+        {
+            return std::allocate_shared<T>(ElementPoolAllocator<T>(std::move(pool)), parent, name);
+        }
         return std::make_shared<T>(parent, name);
     }
 
+    template <class T> static ElementPtr createElement(ElementPtr parent, const string& name)
+    {
+        return allocateElement<T>(parent, name);
+    }
+
   private:
     using CreatorFunction = ElementPtr (*)(ElementPtr, const string&);
     using CreatorMap = std::unordered_map<string, CreatorFunction>;
@@ -1036,10 +1291,24 @@ class MX_CORE_API ValueElement : public TypedElement
     /// Return the typed value of an element as a generic value object, which
     /// may be queried to access its data.
     ///
+    /// The returned object is a new copy, which may be modified by the caller
+    /// without affecting the element.
+    ///
     /// @return A shared pointer to the typed value of this element, or an
     ///    empty shared pointer if no value is present.
     ValuePtr getValue() const;
 
+    /// Return the value of an element as an immutable generic value object.
+    ///
+    /// Values of registered types are parsed once and cached until the value
+    /// or type of the element changes, so the returned object may be shared
+    /// between callers.  Values of struct types, whose parsing depends on the
+    /// typedefs of the document, are parsed on each call.
+    ///
+    /// @return A shared pointer to the typed value of this element, or an
+    ///    empty shared pointer if no value is present.
+    ConstValuePtr getConstValue() const;
+
     /// Return the resolved value of an element as a generic value object, which
     /// may be queried to access its data.
     ///
@@ -1142,6 +1411,14 @@ class MX_CORE_API ValueElement : public TypedElement
 
     /// @}
 
+  protected:
+    void onAttributeChange(const string& attrib) override;
+
+  private:
+    friend class Document;
+
+    mutable ConstValuePtr _cachedValue;
+
   public:
     static const string VALUE_ATTRIBUTE;
     static const string INTERFACE_NAME_ATTRIBUTE;
@@ -1390,6 +1667,29 @@ class MX_CORE_API ElementEquivalenceOptions
     StringSet attributeExclusionList;
 };
 
+/// @class ValidationOptions
+/// A set of options for controlling the behavior of document validation.
+class MX_CORE_API ValidationOptions
+{
+  public:
+    ValidationOptions() :
+        threadCount(1),
+        firstErrorOnly(false)
+    {
+    }
+    ~ValidationOptions() = default;
+
+    /// The number of threads across which the top-level elements of a
+    /// document are validated, where zero selects the number of hardware
+    /// threads.  Messages are reported in the same order for all thread
+    /// counts.  Defaults to 1.
+    unsigned int threadCount;
+
+    /// If true, then validation stops at the first error, and only that error
+    /// is reported.  Defaults to false.
+    bool firstErrorOnly;
+};
+
 /// @class ExceptionOrphanedElement
 /// An exception that is thrown when an ElementPtr is used after its owning
 /// Document has gone out of scope.
@@ -1407,10 +1707,11 @@ template <class T> shared_ptr<T> Element::addChild(const string& name)
         childName = createValidChildName(T::CATEGORY + "1");
     }
 
+    requireChildren();
     if (_childMap.count(childName))
         throw Exception("Child name is not unique: " + childName);
 
-    shared_ptr<T> child = std::make_shared<T>(getSelf(), childName);
+    shared_ptr<T> child = allocateElement<T>(getSelf(), childName);
     registerChildElement(child);
 
     return child;
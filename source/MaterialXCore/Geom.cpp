@@ -160,9 +160,13 @@ bool Collection::matchesGeomString(const string& geom) const
         vector<CollectionPtr> appendVec = collection->getIncludeCollections();
         includedVec.insert(includedVec.end(), appendVec.begin(), appendVec.end());
     }
-    for (ConstCollectionPtr collection : includedSet)
+
+    // The include closure is flattened above, so each included collection
+    // need only test its own include and exclude geometry.
+    for (ConstCollectionPtr collection : includedVec)
     {
-        if (collection->matchesGeomString(geom))
+        if (!geomStringsMatch(collection->getActiveExcludeGeom(), geom, true) &&
+            geomStringsMatch(collection->getActiveIncludeGeom(), geom))
         {
             return true;
         }
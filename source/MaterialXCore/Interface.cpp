@@ -8,6 +8,7 @@
 #include <MaterialXCore/Definition.h>
 #include <MaterialXCore/Document.h>
 
+#include <atomic>
 #include <stdexcept>
 
 MATERIALX_NAMESPACE_BEGIN
@@ -26,6 +27,26 @@ const string Input::OPACITY_HINT = "opacity";
 const string Input::ANISOTROPY_HINT = "anisotropy";
 const string Output::DEFAULT_INPUT_ATTRIBUTE = "defaultinput";
 
+namespace
+{
+
+// Register the attribute names above as interned strings, so that attribute
+// lookups with these constants match stored names by address.
+[[maybe_unused]] const bool ATTRIBUTE_NAMES_INTERNED = []()
+{
+    for (const string* name : { &PortElement::NODE_NAME_ATTRIBUTE, &PortElement::NODE_GRAPH_ATTRIBUTE,
+                                &PortElement::OUTPUT_ATTRIBUTE, &InterfaceElement::NODE_DEF_ATTRIBUTE,
+                                &InterfaceElement::TARGET_ATTRIBUTE, &InterfaceElement::VERSION_ATTRIBUTE,
+                                &InterfaceElement::DEFAULT_VERSION_ATTRIBUTE, &Input::DEFAULT_GEOM_PROP_ATTRIBUTE,
+                                &Input::HINT_ATTRIBUTE, &Output::DEFAULT_INPUT_ATTRIBUTE })
+    {
+        internStaticString(*name);
+    }
+    return true;
+}();
+
+} // anonymous namespace
+
 //
 // PortElement methods
 //
@@ -351,69 +372,109 @@ bool Output::validate(string* message) const
 }
 
 //
-// InterfaceElement methods
+// InterfaceElement::ActiveInterface
 //
 
-InputPtr InterfaceElement::getActiveInput(const string& name) const
+// The inheritance-resolved children of an interface element, as of a given
+// document revision.
+class InterfaceElement::ActiveInterface
 {
-    for (ConstElementPtr elem : traverseInheritance())
+  public:
+    template <class T> class ChildList
     {
-        InputPtr input = elem->asA<InterfaceElement>()->getInput(name);
-        if (input)
+      public:
+        // Append the given children, skipping any whose names have already
+        // been added if requested.
+        void append(const vector<shared_ptr<T>>& children, bool unique)
         {
-            return input;
+            for (const shared_ptr<T>& child : children)
+            {
+                if (indexMap.emplace(child->getName(), elements.size()).second || !unique)
+                {
+                    elements.push_back(child);
+                }
+            }
         }
-    }
-    return nullptr;
-}
 
-vector<InputPtr> InterfaceElement::getActiveInputs() const
-{
-    vector<InputPtr> activeInputs;
-    StringSet activeInputNamesSet;
-    for (ConstElementPtr elem : traverseInheritance())
+        shared_ptr<T> find(const string& name) const
+        {
+            auto it = indexMap.find(name);
+            return (it != indexMap.end()) ? elements[it->second] : nullptr;
+        }
+
+        vector<shared_ptr<T>> elements;
+        std::unordered_map<string, size_t> indexMap;
+    };
+
+  public:
+    explicit ActiveInterface(const InterfaceElement& interfaceElem)
     {
-        vector<InputPtr> inputs = elem->asA<InterfaceElement>()->getInputs();
-        for (const InputPtr& input : inputs)
+        for (ConstElementPtr elem : interfaceElem.traverseInheritance())
         {
-            if (input && activeInputNamesSet.insert(input->getName()).second)
-            {
-                activeInputs.push_back(input);
-            }
+            ConstInterfaceElementPtr super = elem->asA<InterfaceElement>();
+            inputs.append(super->getInputs(), true);
+            outputs.append(super->getOutputs(), true);
+            tokens.append(super->getTokens(), false);
+            valueElements.append(super->getChildrenOfType<ValueElement>(), true);
         }
     }
-    return activeInputs;
-}
 
-OutputPtr InterfaceElement::getActiveOutput(const string& name) const
+    size_t revision = 0;
+    ChildList<Input> inputs;
+    ChildList<Output> outputs;
+    ChildList<Token> tokens;
+    ChildList<ValueElement> valueElements;
+};
+
+//
+// InterfaceElement methods
+//
+
+InterfaceElement::ActiveInterfacePtr InterfaceElement::getActiveInterface() const
 {
-    for (ConstElementPtr elem : traverseInheritance())
+    // Elements that are no longer part of a document are not cached.
+    ElementPtr root = _root.lock();
+    ConstDocumentPtr doc = root ? root->asA<Document>() : nullptr;
+    if (!doc)
     {
-        OutputPtr output = elem->asA<InterfaceElement>()->getOutput(name);
-        if (output)
-        {
-            return output;
-        }
+        return std::make_shared<ActiveInterface>(*this);
     }
-    return nullptr;
+
+    // Return the stored interface if it is current.  Since documents must not
+    // be modified while being read by other threads, any interface that is
+    // concurrently published for the same revision is identical.
+    size_t revision = doc->getRevision();
+    ActiveInterfacePtr active = std::atomic_load(&_activeInterface);
+    if (active && active->revision == revision)
+    {
+        return active;
+    }
+
+    auto newActive = std::make_shared<ActiveInterface>(*this);
+    newActive->revision = revision;
+    active = newActive;
+    std::atomic_store(&_activeInterface, active);
+    return active;
+}
+
+InputPtr InterfaceElement::getActiveInput(const string& name) const
+{
+    return getActiveInterface()->inputs.find(name);
+}
+
+vector<InputPtr> InterfaceElement::getActiveInputs() const
+{
+    return getActiveInterface()->inputs.elements;
+}
+
+OutputPtr InterfaceElement::getActiveOutput(const string& name) const
+{
+    return getActiveInterface()->outputs.find(name);
 }
 
 vector<OutputPtr> InterfaceElement::getActiveOutputs() const
 {
-    vector<OutputPtr> activeOutputs;
-    StringSet activeOutputNamesSet;
-    for (ConstElementPtr elem : traverseInheritance())
-    {
-        vector<OutputPtr> outputs = elem->asA<InterfaceElement>()->getOutputs();
-        for (const OutputPtr& output : outputs)
-        {
-            if (output && activeOutputNamesSet.insert(output->getName()).second)
-            {
-                activeOutputs.push_back(output);
-            }
-        }
-    }
-    return activeOutputs;
+    return getActiveInterface()->outputs.elements;
 }
 
 void InterfaceElement::setConnectedOutput(const string& inputName, OutputPtr output)
@@ -442,57 +503,22 @@ OutputPtr InterfaceElement::getConnectedOutput(const string& inputName) const
 
 TokenPtr InterfaceElement::getActiveToken(const string& name) const
 {
-    for (ConstElementPtr elem : traverseInheritance())
-    {
-        TokenPtr token = elem->asA<InterfaceElement>()->getToken(name);
-        if (token)
-        {
-            return token;
-        }
-    }
-    return nullptr;
+    return getActiveInterface()->tokens.find(name);
 }
 
 vector<TokenPtr> InterfaceElement::getActiveTokens() const
 {
-    vector<TokenPtr> activeTokens;
-    for (ConstElementPtr elem : traverseInheritance())
-    {
-        vector<TokenPtr> tokens = elem->asA<InterfaceElement>()->getTokens();
-        activeTokens.insert(activeTokens.end(), tokens.begin(), tokens.end());
-    }
-    return activeTokens;
+    return getActiveInterface()->tokens.elements;
 }
 
 ValueElementPtr InterfaceElement::getActiveValueElement(const string& name) const
 {
-    for (ConstElementPtr interface : traverseInheritance())
-    {
-        ValueElementPtr valueElem = interface->getChildOfType<ValueElement>(name);
-        if (valueElem)
-        {
-            return valueElem;
-        }
-    }
-    return nullptr;
+    return getActiveInterface()->valueElements.find(name);
 }
 
 vector<ValueElementPtr> InterfaceElement::getActiveValueElements() const
 {
-    vector<ValueElementPtr> activeValueElems;
-    StringSet activeValueElemNamesSet;
-    for (ConstElementPtr interface : traverseInheritance())
-    {
-        vector<ValueElementPtr> valueElems = interface->getChildrenOfType<ValueElement>();
-        for (const ValueElementPtr& valueElem : valueElems)
-        {
-            if (valueElem && activeValueElemNamesSet.insert(valueElem->getName()).second)
-            {
-                activeValueElems.push_back(valueElem);
-            }
-        }
-    }
-    return activeValueElems;
+    return getActiveInterface()->valueElements.elements;
 }
 
 ValuePtr InterfaceElement::getInputValue(const string& name, const string& target) const
@@ -656,9 +656,21 @@ class MX_CORE_API InterfaceElement : public TypedElement
     void registerChildElement(ElementPtr child) override;
     void unregisterChildElement(ElementPtr child) override;
 
+  private:
+    class ActiveInterface;
+    using ActiveInterfacePtr = shared_ptr<const ActiveInterface>;
+
+    // Return the inheritance-resolved interface of this element, computing
+    // and storing it if the document has changed since it was last computed.
+    // The stored interface is keyed on the document revision alone, so any
+    // change to the document or its data library, including changes that do
+    // not affect this element, causes it to be recomputed on next access.
+    ActiveInterfacePtr getActiveInterface() const;
+
   private:
     size_t _inputCount;
     size_t _outputCount;
+    mutable ActiveInterfacePtr _activeInterface;
 };
 
 template <class T> InputPtr InterfaceElement::setInputValue(const string& name,
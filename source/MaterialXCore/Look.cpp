@@ -20,6 +20,44 @@ const string Visibility::VISIBLE_ATTRIBUTE = "visible";
 const string LookGroup::LOOKS_ATTRIBUTE = "looks";
 const string LookGroup::ACTIVE_ATTRIBUTE = "active";
 
+namespace
+{
+
+// Split a geometry string into the segments of each of its paths.
+vector<StringVec> splitGeomPaths(const string& geom)
+{
+    vector<StringVec> paths;
+    for (const string& name : splitString(geom, ARRAY_VALID_SEPARATORS))
+    {
+        paths.push_back(splitString(name, GEOM_PATH_SEPARATOR));
+    }
+    return paths;
+}
+
+// Return true if any path in the first set matches any path in the second,
+// following the rules of GeomPath::isMatching.
+bool geomPathsMatch(const vector<StringVec>& paths1, const vector<StringVec>& paths2, bool contains)
+{
+    for (const StringVec& path2 : paths2)
+    {
+        for (const StringVec& path1 : paths1)
+        {
+            if (contains && path1.size() > path2.size())
+            {
+                continue;
+            }
+            size_t minSize = std::min(path1.size(), path2.size());
+            if (std::equal(path1.begin(), path1.begin() + minSize, path2.begin()))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+} // anonymous namespace
+
 vector<MaterialAssignPtr> getGeometryBindings(ConstNodePtr materialNode, const string& geom)
 {
     vector<MaterialAssignPtr> matAssigns;
@@ -46,6 +84,200 @@ vector<MaterialAssignPtr> getGeometryBindings(ConstNodePtr materialNode, const s
     return matAssigns;
 }
 
+//
+// GeometryBindingResolver methods
+//
+
+GeometryBindingResolver::GeometryBindingResolver(ConstDocumentPtr doc) :
+    _trie(1)
+{
+    std::unordered_map<const Element*, size_t> collectionIndices;
+    for (LookPtr look : doc->getLooks())
+    {
+        for (MaterialAssignPtr matAssign : look->getMaterialAssigns())
+        {
+            size_t assignIndex = _assigns.size();
+            _assigns.push_back(matAssign);
+            _materials.push_back(matAssign->getReferencedMaterial());
+            addGeomPaths(assignIndex, matAssign->getActiveGeom());
+            CollectionPtr coll = matAssign->getCollection();
+            if (coll)
+            {
+                _collectionAssigns.emplace_back(assignIndex, addCollection(coll, collectionIndices));
+            }
+        }
+    }
+}
+
+vector<MaterialAssignPtr> GeometryBindingResolver::getBindings(const string& geom, ConstNodePtr materialNode) const
+{
+    vector<uint8_t> flags;
+    vector<MaterialAssignPtr> bindings;
+    resolve(geom, materialNode, flags, bindings);
+    return bindings;
+}
+
+vector<vector<MaterialAssignPtr>> GeometryBindingResolver::getBatchBindings(const StringVec& geoms, ConstNodePtr materialNode) const
+{
+    vector<uint8_t> flags;
+    vector<vector<MaterialAssignPtr>> bindings(geoms.size());
+    for (size_t i = 0; i < geoms.size(); i++)
+    {
+        resolve(geoms[i], materialNode, flags, bindings[i]);
+    }
+    return bindings;
+}
+
+size_t GeometryBindingResolver::addCollection(ConstCollectionPtr collection, std::unordered_map<const Element*, size_t>& collectionIndices)
+{
+    auto it = collectionIndices.find(collection.get());
+    if (it != collectionIndices.end())
+    {
+        return it->second;
+    }
+    size_t index = _collections.size();
+    collectionIndices[collection.get()] = index;
+    _collections.emplace_back();
+    _collections[index].name = collection->getName();
+    _collections[index].includePaths = splitGeomPaths(collection->getActiveIncludeGeom());
+    _collections[index].excludePaths = splitGeomPaths(collection->getActiveExcludeGeom());
+
+    // Flatten the included collections, detecting cycles in the same manner
+    // as Collection::matchesGeomString.
+    std::set<CollectionPtr> includedSet;
+    vector<CollectionPtr> includedVec = collection->getIncludeCollections();
+    for (size_t i = 0; i < includedVec.size(); i++)
+    {
+        CollectionPtr included = includedVec[i];
+        if (includedSet.count(included))
+        {
+            _collections[index].hasCycle = true;
+            return index;
+        }
+        includedSet.insert(included);
+        vector<CollectionPtr> appendVec = included->getIncludeCollections();
+        includedVec.insert(includedVec.end(), appendVec.begin(), appendVec.end());
+    }
+    vector<size_t> closure;
+    for (CollectionPtr included : includedVec)
+    {
+        closure.push_back(addCollection(included, collectionIndices));
+    }
+    _collections[index].closure = std::move(closure);
+    return index;
+}
+
+void GeometryBindingResolver::addGeomPaths(size_t assignIndex, const string& geom)
+{
+    for (const StringVec& path : splitGeomPaths(geom))
+    {
+        size_t nodeIndex = 0;
+        for (const string& segment : path)
+        {
+            auto it = _trie[nodeIndex].children.find(segment);
+            if (it == _trie[nodeIndex].children.end())
+            {
+                it = _trie[nodeIndex].children.emplace(segment, _trie.size()).first;
+                _trie.emplace_back();
+            }
+            nodeIndex = it->second;
+        }
+        _trie[nodeIndex].assigns.push_back(assignIndex);
+    }
+}
+
+void GeometryBindingResolver::resolve(const string& geom, ConstNodePtr materialNode, vector<uint8_t>& flags, vector<MaterialAssignPtr>& bindings) const
+{
+    // Flags are stored per assignment, followed by per-collection flags
+    // recording whether the collection's own include and exclude paths, and
+    // its full include closure, have been evaluated and matched.
+    const uint8_t MATCHED = 1 << 0;
+    const uint8_t OWN_EVALUATED = 1 << 1;
+    const uint8_t OWN_MATCHED = 1 << 2;
+    const uint8_t EVALUATED = 1 << 3;
+    flags.assign(_assigns.size() + _collections.size(), 0);
+    uint8_t* collectionFlags = flags.data() + _assigns.size();
+
+    // Mark assignments whose geometry paths contain a query path, by walking
+    // each query path down the trie.
+    const vector<StringVec> paths = splitGeomPaths(geom);
+    for (const StringVec& path : paths)
+    {
+        const TrieNode* node = &_trie[0];
+        for (size_t i = 0; node; i++)
+        {
+            for (size_t assignIndex : node->assigns)
+            {
+                flags[assignIndex] |= MATCHED;
+            }
+            if (i == path.size())
+            {
+                break;
+            }
+            auto it = node->children.find(path[i]);
+            node = (it != node->children.end()) ? &_trie[it->second] : nullptr;
+        }
+    }
+
+    // Mark the remaining assignments whose collections match the query.
+    auto matchesOwnPaths = [&](size_t index) -> bool
+    {
+        if (!(collectionFlags[index] & OWN_EVALUATED))
+        {
+            const CompiledCollection& coll = _collections[index];
+            bool matched = !geomPathsMatch(coll.excludePaths, paths, true) &&
+                           geomPathsMatch(coll.includePaths, paths, false);
+            collectionFlags[index] |= OWN_EVALUATED | (matched ? OWN_MATCHED : 0);
+        }
+        return collectionFlags[index] & OWN_MATCHED;
+    };
+    auto matchesCollection = [&](size_t index) -> bool
+    {
+        if (!(collectionFlags[index] & EVALUATED))
+        {
+            const CompiledCollection& coll = _collections[index];
+            bool matched = false;
+            if (!geomPathsMatch(coll.excludePaths, paths, true))
+            {
+                matched = geomPathsMatch(coll.includePaths, paths, false);
+                if (!matched && coll.hasCycle)
+                {
+                    throw ExceptionFoundCycle("Encountered a cycle in collection: " + coll.name);
+                }
+                for (size_t i = 0; !matched && i < coll.closure.size(); i++)
+                {
+                    matched = matchesOwnPaths(coll.closure[i]);
+                }
+            }
+            collectionFlags[index] |= EVALUATED | (matched ? MATCHED : 0);
+        }
+        return collectionFlags[index] & MATCHED;
+    };
+    for (const auto& pair : _collectionAssigns)
+    {
+        if (flags[pair.first] & MATCHED)
+        {
+            continue;
+        }
+        if (materialNode && _materials[pair.first] != materialNode)
+        {
+            continue;
+        }
+        if (matchesCollection(pair.second))
+        {
+            flags[pair.first] |= MATCHED;
+        }
+    }
+
+    for (size_t i = 0; i < _assigns.size(); i++)
+    {
+        if ((flags[i] & MATCHED) && (!materialNode || _materials[i] == materialNode))
+        {
+            bindings.push_back(_assigns[i]);
+        }
+    }
+}
+
 //
 // Look methods
 //
@@ -22,6 +22,7 @@ class LookGroup;
 class LookInherit;
 class MaterialAssign;
 class Visibility;
+class GeometryBindingResolver;
 
 /// A shared pointer to a Look
 using LookPtr = shared_ptr<Look>;
@@ -497,6 +498,77 @@ class MX_CORE_API Visibility : public GeomElement
 /// @return Vector of MaterialAssign elements
 MX_CORE_API vector<MaterialAssignPtr> getGeometryBindings(ConstNodePtr materialNode, const string& geom = UNIVERSAL_GEOM_NAME);
 
+/// @class GeometryBindingResolver
+/// A precompiled index of the material assignments in a document, for
+/// resolving the material bindings of many geometry strings.
+///
+/// The geometry paths of all material assignments are stored in a prefix
+/// trie, and the include and exclude paths of their collections are parsed
+/// and flattened once, so that each query is proportional to the depth of
+/// its geometry paths rather than to the number of assignments.  Results
+/// match those of getGeometryBindings.
+///
+/// A resolver is a snapshot of its document, and should be reconstructed
+/// after the looks, material assignments or collections of the document are
+/// edited.
+class MX_CORE_API GeometryBindingResolver
+{
+  public:
+    /// Construct a resolver for the material assignments of all looks in
+    /// the given document.
+    explicit GeometryBindingResolver(shared_ptr<const Document> doc);
+    ~GeometryBindingResolver() = default;
+
+    /// Return a vector of all MaterialAssign elements that bind a material
+    /// to the given geometry string, in document order.
+    /// @param geom The geometry for which material bindings should be returned.
+    /// @param materialNode If provided, then only bindings of this material
+    ///    node are returned.
+    vector<MaterialAssignPtr> getBindings(const string& geom, ConstNodePtr materialNode = nullptr) const;
+
+    /// Return the material bindings of each of the given geometry strings.
+    /// @param geoms The geometry strings for which material bindings should
+    ///    be returned.
+    /// @param materialNode If provided, then only bindings of this material
+    ///    node are returned.
+    /// @return A vector with one entry per geometry string, each holding the
+    ///    bindings that getBindings would return for that string.
+    vector<vector<MaterialAssignPtr>> getBatchBindings(const StringVec& geoms, ConstNodePtr materialNode = nullptr) const;
+
+    /// Return the number of material assignments in the resolver.
+    size_t getAssignCount() const
+    {
+        return _assigns.size();
+    }
+
+  private:
+    struct TrieNode
+    {
+        std::unordered_map<string, size_t> children;
+        vector<size_t> assigns;
+    };
+
+    struct CompiledCollection
+    {
+        string name;
+        vector<StringVec> includePaths;
+        vector<StringVec> excludePaths;
+        vector<size_t> closure;
+        bool hasCycle = false;
+    };
+
+    size_t addCollection(ConstCollectionPtr collection, std::unordered_map<const Element*, size_t>& collectionIndices);
+    void addGeomPaths(size_t assignIndex, const string& geom);
+    void resolve(const string& geom, ConstNodePtr materialNode, vector<uint8_t>& flags, vector<MaterialAssignPtr>& bindings) const;
+
+  private:
+    vector<MaterialAssignPtr> _assigns;
+    vector<NodePtr> _materials;
+    vector<TrieNode> _trie;
+    vector<std::pair<size_t, size_t>> _collectionAssigns;
+    vector<CompiledCollection> _collections;
+};
+
 MATERIALX_NAMESPACE_END
 
 #endif
@@ -9,6 +9,7 @@
 #include <MaterialXCore/Material.h>
 
 #include <deque>
+#include <mutex>
 
 MATERIALX_NAMESPACE_BEGIN
 
@@ -85,33 +86,7 @@ NodeDefPtr Node::getNodeDef(const string& target, bool allowRoughMatch) const
     {
         return resolveNameReference<NodeDef>(getNodeDefString());
     }
-    vector<NodeDefPtr> nodeDefs = getDocument()->getMatchingNodeDefs(getQualifiedName(getCategory()));
-    vector<NodeDefPtr> secondary = getDocument()->getMatchingNodeDefs(getCategory());
-    vector<NodeDefPtr> roughMatches;
-    nodeDefs.insert(nodeDefs.end(), secondary.begin(), secondary.end());
-    for (NodeDefPtr nodeDef : nodeDefs)
-    {
-        if (!targetStringsMatch(nodeDef->getTarget(), target) ||
-            !nodeDef->isVersionCompatible(getVersionString()) ||
-            nodeDef->getType() != getType())
-        {
-            continue;
-        }
-        if (!hasExactInputMatch(nodeDef))
-        {
-            if (allowRoughMatch)
-            {
-                roughMatches.push_back(nodeDef);
-            }
-            continue;
-        }
-        return nodeDef;
-    }
-    if (!roughMatches.empty())
-    {
-        return roughMatches[0];
-    }
-    return NodeDefPtr();
+    return getDocument()->matchNodeDef(*this, target, allowRoughMatch);
 }
 
 Edge Node::getUpstreamEdge(size_t index) const
@@ -781,8 +756,64 @@ vector<PortElementPtr> NodeGraph::getDownstreamPorts() const
     return downstreamPorts;
 }
 
+void NodeGraph::setDeferredBody(NodeGraphBodyLoader loader)
+{
+    std::lock_guard<std::recursive_mutex> lock(getDocument()->getDeferredBodyMutex());
+    _hasDeferredBody.store(loader != nullptr, std::memory_order_release);
+    _deferredBody = std::move(loader);
+}
+
+NodeGraphBodyLoader NodeGraph::getDeferredBody() const
+{
+    if (!hasDeferredBody())
+    {
+        return nullptr;
+    }
+    std::lock_guard<std::recursive_mutex> lock(getDocument()->getDeferredBodyMutex());
+    return _deferredBody;
+}
+
+void NodeGraph::loadDeferredBody() const
+{
+    if (!hasDeferredBody())
+    {
+        return;
+    }
+    std::lock_guard<std::recursive_mutex> lock(getDocument()->getDeferredBodyMutex());
+    if (!_deferredBody)
+    {
+        return;
+    }
+
+    // The flag is cleared only once the body has been read.  While the body
+    // is being read, the loader is held aside, so that accesses to
+    // the children of this graph from the loader itself return immediately.
+    NodeGraphBodyLoader loader = std::move(_deferredBody);
+    _deferredBody = nullptr;
+    NodeGraphPtr graph = std::const_pointer_cast<NodeGraph>(asA<NodeGraph>());
+    const size_t childCount = _childOrder.size();
+    try
+    {
+        loader(graph);
+    }
+    catch (...)
+    {
+        // Discard any partially read body, and restore the loader so that a
+        // later access may retry.
+        while (_childOrder.size() > childCount)
+        {
+            graph->removeChild(_childOrder.back()->getName());
+        }
+        _deferredBody = std::move(loader);
+        throw;
+    }
+    _hasDeferredBody.store(false, std::memory_order_release);
+}
+
 bool NodeGraph::validate(string* message) const
 {
+    loadDeferredBody();
+
     bool res = true;
 
     validateRequire(!hasVersionString(), res, message, "NodeGraph elements do not support version strings");
@@ -44,6 +44,9 @@ using ConstBackdropPtr = shared_ptr<const Backdrop>;
 // that criteria has passed
 using NodePredicate = std::function<bool(NodePtr node)>;
 
+/// A function that reads the deferred body of a NodeGraph into the given graph.
+using NodeGraphBodyLoader = std::function<void(NodeGraphPtr graph)>;
+
 /// @class Node
 /// A node element within a NodeGraph or Document.
 ///
@@ -399,6 +402,38 @@ class MX_CORE_API NodeGraph : public GraphElement
     /// @param interfaceName The new interface name.
     void modifyInterfaceName(const string& inputPath, const string& interfaceName);
 
+    /// @}
+    /// @name Deferred Body
+    /// @{
+
+    /// Set a function that reads the child elements of this graph on first
+    /// access, allowing the bodies of library graphs to be loaded on demand.
+    /// Passing an empty function clears any deferred body.
+    void setDeferredBody(NodeGraphBodyLoader loader);
+
+    /// Return the function that reads the deferred body of this graph, if any.
+    NodeGraphBodyLoader getDeferredBody() const;
+
+    /// Return true if this graph has a deferred body that has not yet been read.
+    bool hasDeferredBody() const
+    {
+        return _hasDeferredBody.load(std::memory_order_acquire);
+    }
+
+    /// Read the deferred body of this graph, if any.  This method is invoked
+    /// automatically whenever the child elements of the graph are accessed,
+    /// and when the graph is returned by Document::getNodeGraph or
+    /// NodeDef::getImplementation.  If the body cannot be read, then an
+    /// exception is thrown, any partially read children are discarded, and
+    /// the body remains deferred.
+    ///
+    /// Reading a body adds elements to the document, even when it is
+    /// triggered by a const accessor, so a document with deferred bodies
+    /// must only be accessed from one thread at a time.  Document::freeze
+    /// reads all deferred bodies, after which the document may be shared
+    /// across threads.
+    void loadDeferredBody() const;
+
     /// @}
     /// @name Validation
     /// @{
@@ -411,6 +446,9 @@ class MX_CORE_API NodeGraph : public GraphElement
 
   public:
     static const string CATEGORY;
+
+  private:
+    mutable NodeGraphBodyLoader _deferredBody;
 };
 
 /// @class Backdrop
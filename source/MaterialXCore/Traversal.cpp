@@ -85,13 +85,13 @@ TreeIterator& TreeIterator::operator++()
 size_t GraphIterator::getNodeDepth() const
 {
     size_t nodeDepth = 0;
-    for (ElementPtr elem : _pathElems)
+    _pathElems.forEach([&nodeDepth](const ElementSet::Tuple& tuple)
     {
-        if (elem->isA<Node>())
+        if (tuple[0]->isA<Node>())
         {
             nodeDepth++;
         }
-    }
+    });
     return nodeDepth;
 }
 
@@ -159,28 +159,28 @@ GraphIterator& GraphIterator::operator++()
 void GraphIterator::extendPathUpstream(ElementPtr upstreamElem, ElementPtr connectingElem)
 {
     // Check for cycles.
-    if (_pathElems.count(upstreamElem))
+    if (!_pathElems.insert({ upstreamElem.get() }))
     {
         throw ExceptionFoundCycle("Encountered cycle at element: " + upstreamElem->asString());
     }
 
     // Extend the current path to the new element.
-    _pathElems.insert(upstreamElem);
     _upstreamElem = upstreamElem;
     _connectingElem = connectingElem;
 }
 
 void GraphIterator::returnPathDownstream(ElementPtr upstreamElem)
 {
-    _pathElems.erase(upstreamElem);
+    _pathElems.erase({ upstreamElem.get() });
     _upstreamElem = ElementPtr();
     _connectingElem = ElementPtr();
 }
 
 bool GraphIterator::skipOrMarkAsVisited(const Edge& edge)
 {
-    auto [it, inserted] = _visitedEdges.emplace(edge);
-    return !inserted;
+    return !_visitedEdges.insert({ edge.getDownstreamElement().get(),
+                                   edge.getConnectingElement().get(),
+                                   edge.getUpstreamElement().get() });
 }
 
 //
@@ -210,11 +210,10 @@ InheritanceIterator& InheritanceIterator::operator++()
         if (super)
         {
             // Check for cycles.
-            if (_pathElems.count(super))
+            if (!_pathElems.insert({ super.get() }))
             {
                 throw ExceptionFoundCycle("Encountered cycle at element: " + super->asString());
             }
-            _pathElems.insert(super);
         }
         _elem = super;
     }
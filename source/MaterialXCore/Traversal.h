@@ -11,6 +11,8 @@
 
 #include <MaterialXCore/Exception.h>
 
+#include <array>
+
 MATERIALX_NAMESPACE_BEGIN
 
 class Element;
@@ -81,6 +83,180 @@ class MX_CORE_API Edge
     ElementPtr _elemUp;
 };
 
+namespace internal
+{
+
+// A set of fixed-size tuples of element pointers, used for bookkeeping
+// within the traversal iterators below.  This class is an implementation
+// detail of those iterators, and is not part of the public API.
+//
+// Tuples hold raw pointers, which the set compares and hashes by address
+// but never dereferences.  The set does not keep elements alive, so its
+// owner must ensure that each stored element outlives its entry, both before
+// dereferencing a stored pointer and so that a freed address cannot be
+// reused by a new element.  The traversal iterators hold shared pointers to
+// the elements on their current path, and require that the traversed
+// document is not modified during traversal.
+//
+// Up to InlineCount tuples are stored inline and searched linearly, which
+// is efficient for the shallow paths of typical graphs.  Larger sets are
+// stored in an open-addressed hash table with linear probing.  Tuples whose
+// elements are all null are reserved as empty slots and cannot be stored.
+template <size_t Arity, size_t InlineCount> class ElementTupleSet
+{
+  public:
+    using Tuple = std::array<const Element*, Arity>;
+
+  public:
+    /// Return true if the given tuple is in the set.
+    bool contains(const Tuple& tuple) const
+    {
+        if (_table.empty())
+        {
+            return std::find(_inline.begin(), _inline.begin() + _size, tuple) != _inline.begin() + _size;
+        }
+        return _table[findSlot(tuple)] == tuple;
+    }
+
+    /// Insert the given tuple, returning true if it was not already present.
+    bool insert(const Tuple& tuple)
+    {
+        if (_table.empty())
+        {
+            if (std::find(_inline.begin(), _inline.begin() + _size, tuple) != _inline.begin() + _size)
+            {
+                return false;
+            }
+            if (_size < InlineCount)
+            {
+                _inline[_size++] = tuple;
+                return true;
+            }
+            rehash(InlineCount * 4);
+            for (size_t i = 0; i < _size; i++)
+            {
+                _table[findSlot(_inline[i])] = _inline[i];
+            }
+        }
+        else if ((_size + 1) * 2 > _table.size())
+        {
+            rehash(_table.size() * 2);
+        }
+
+        Tuple& slot = _table[findSlot(tuple)];
+        if (slot == tuple)
+        {
+            return false;
+        }
+        slot = tuple;
+        _size++;
+        return true;
+    }
+
+    /// Remove the given tuple, if present.
+    void erase(const Tuple& tuple)
+    {
+        if (_table.empty())
+        {
+            auto it = std::find(_inline.begin(), _inline.begin() + _size, tuple);
+            if (it != _inline.begin() + _size)
+            {
+                *it = _inline[--_size];
+            }
+            return;
+        }
+
+        size_t index = findSlot(tuple);
+        if (_table[index] != tuple)
+        {
+            return;
+        }
+
+        // Shift subsequent entries of the probe sequence back into the
+        // vacated slot, so that no tombstones are required.
+        const size_t mask = _table.size() - 1;
+        for (size_t next = (index + 1) & mask; _table[next] != Tuple(); next = (next + 1) & mask)
+        {
+            size_t home = getHash(_table[next]) & mask;
+            if (((next - home) & mask) >= ((next - index) & mask))
+            {
+                _table[index] = _table[next];
+                index = next;
+            }
+        }
+        _table[index] = Tuple();
+        _size--;
+    }
+
+    /// Call the given function for each tuple in the set, in no particular order.
+    template <class F> void forEach(F func) const
+    {
+        if (_table.empty())
+        {
+            std::for_each(_inline.begin(), _inline.begin() + _size, func);
+            return;
+        }
+        for (const Tuple& tuple : _table)
+        {
+            if (tuple != Tuple())
+            {
+                func(tuple);
+            }
+        }
+    }
+
+    /// Return the number of tuples in the set.
+    size_t size() const
+    {
+        return _size;
+    }
+
+  private:
+    static size_t getHash(const Tuple& tuple)
+    {
+        uint64_t hash = 0;
+        for (const Element* elem : tuple)
+        {
+            hash = (hash ^ (uint64_t) (uintptr_t) elem) * 0x9e3779b97f4a7c15ull;
+            hash ^= hash >> 32;
+        }
+        return (size_t) hash;
+    }
+
+    // Return the slot holding the given tuple, or the empty slot at which it
+    // would be inserted.
+    size_t findSlot(const Tuple& tuple) const
+    {
+        const size_t mask = _table.size() - 1;
+        size_t index = getHash(tuple) & mask;
+        while (_table[index] != tuple && _table[index] != Tuple())
+        {
+            index = (index + 1) & mask;
+        }
+        return index;
+    }
+
+    void rehash(size_t capacity)
+    {
+        vector<Tuple> previous(capacity);
+        previous.swap(_table);
+        for (const Tuple& tuple : previous)
+        {
+            if (tuple != Tuple())
+            {
+                _table[findSlot(tuple)] = tuple;
+            }
+        }
+    }
+
+  private:
+    std::array<Tuple, InlineCount> _inline{};
+    vector<Tuple> _table;
+    size_t _size = 0;
+};
+
+} // namespace internal
+
 /// @class TreeIterator
 /// An iterator object representing the state of a tree traversal.
 ///
@@ -196,12 +372,16 @@ class MX_CORE_API GraphIterator
         _prune(false),
         _holdCount(0)
     {
-        _pathElems.insert(elem);
+        if (elem)
+        {
+            _pathElems.insert({ elem.get() });
+        }
     }
     ~GraphIterator() = default;
 
   private:
-    using ElementSet = std::set<ElementPtr>;
+    using ElementSet = internal::ElementTupleSet<1, 16>;
+    using EdgeSet = internal::ElementTupleSet<3, 16>;
     using StackFrame = std::pair<ElementPtr, size_t>;
 
   public:
@@ -323,7 +503,7 @@ class MX_CORE_API GraphIterator
     ElementPtr _connectingElem;
     ElementSet _pathElems;
     vector<StackFrame> _stack;
-    std::set<Edge> _visitedEdges;
+    EdgeSet _visitedEdges;
     bool _prune;
     size_t _holdCount;
 };
@@ -339,12 +519,15 @@ class MX_CORE_API InheritanceIterator
         _elem(elem),
         _holdCount(0)
     {
-        _pathElems.insert(elem);
+        if (elem)
+        {
+            _pathElems.insert({ elem.get() });
+        }
     }
     ~InheritanceIterator() = default;
 
   private:
-    using ConstElementSet = std::set<ConstElementPtr>;
+    using ConstElementSet = internal::ElementTupleSet<1, 8>;
 
   public:
     bool operator==(const InheritanceIterator& rhs) const
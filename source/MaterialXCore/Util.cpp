@@ -6,6 +6,9 @@
 #include <MaterialXCore/Types.h>
 
 #include <cctype>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
 
 MATERIALX_NAMESPACE_BEGIN
 
@@ -27,6 +30,45 @@ bool invalidNameChar(char c)
     return !isalnum((unsigned char) c) && c != '_' && c != ':';
 }
 
+// A table of interned strings, mapping each value to its interned copy.  The
+// interned copy is either the key of its entry, or a registered string with
+// static storage duration.
+class InternTable
+{
+  public:
+    const string& intern(const string& str, const string* staticCopy)
+    {
+        {
+            std::shared_lock<std::shared_mutex> lock(_mutex);
+            auto it = _strings.find(str);
+            if (it != _strings.end())
+            {
+                return *it->second;
+            }
+        }
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        auto result = _strings.emplace(str, staticCopy);
+        if (!result.first->second)
+        {
+            result.first->second = &result.first->first;
+        }
+        return *result.first->second;
+    }
+
+  private:
+    std::shared_mutex _mutex;
+    std::unordered_map<string, const string*> _strings;
+};
+
+// Return the global intern table.  The table is intentionally never
+// destroyed, so that interned strings that it owns remain valid during static
+// destruction.
+InternTable& getInternTable()
+{
+    static InternTable* table = new InternTable();
+    return *table;
+}
+
 } // anonymous namespace
 
 //
@@ -156,6 +198,16 @@ string trimSpaces(const string& str)
     return result;
 }
 
+const string& internString(const string& str)
+{
+    return getInternTable().intern(str, nullptr);
+}
+
+const string& internStaticString(const string& str)
+{
+    return getInternTable().intern(str, &str);
+}
+
 StringVec splitNamePath(const string& namePath)
 {
     StringVec nameVec = splitString(namePath, NAME_PATH_SEPARATOR);
@@ -54,6 +54,17 @@ MX_CORE_API bool stringEndsWith(const string& str, const string& suffix);
 /// Trim leading and trailing spaces from a string.
 MX_CORE_API string trimSpaces(const string& str);
 
+/// Return the interned copy of the given string.  Equal strings share a single
+/// interned copy, which remains valid for the lifetime of the process, so
+/// interned strings may be compared by address.  This method is thread-safe.
+MX_CORE_API const string& internString(const string& str);
+
+/// Register a string with static storage duration as the interned copy of
+/// its value, if no copy of the value has yet been interned, and return the
+/// interned copy.  Registering frequently used constants allows them to be
+/// matched against interned strings by address.  This method is thread-safe.
+MX_CORE_API const string& internStaticString(const string& str);
+
 /// Combine the hash of a value with an existing seed.
 template <typename T> void hashCombine(size_t& seed, const T& value)
 {
@@ -7,8 +7,11 @@
 #include <MaterialXCore/Document.h>
 #include <MaterialXCore/Value.h>
 
+#include <cctype>
+#include <charconv>
 #include <iomanip>
 #include <sstream>
+#include <string_view>
 #include <type_traits>
 
 MATERIALX_NAMESPACE_BEGIN
@@ -31,76 +34,158 @@ template <class T> class is_std_vector<vector<T>> : public std::true_type { };
 template <class T> using enable_if_std_vector_t =
     typename std::enable_if<is_std_vector<T>::value, T>::type;
 
-template <class T> void stringToData(const string& str, T& data)
+template <class T> using enable_if_floating_point_t =
+    typename std::enable_if<std::is_floating_point<T>::value, T>::type;
+template <class T> using enable_if_integral_t =
+    typename std::enable_if<std::is_integral<T>::value, T>::type;
+
+// Floating-point conversions use std::from_chars and std::to_chars where the
+// standard library supports them, and otherwise fall back to streams.
+#if defined(__cpp_lib_to_chars)
+    #define MATERIALX_FLOAT_CHARCONV
+#endif
+
+// Return the start of the given string, skipping leading whitespace and any
+// explicit positive sign, as formatted stream input would.
+const char* skipPrefix(const char* first, const char* last)
 {
-    std::stringstream ss(str);
+    while (first != last && std::isspace((unsigned char) *first))
+    {
+        first++;
+    }
+    if (first != last && *first == '+' && last - first > 1 && first[1] != '+' && first[1] != '-')
+    {
+        first++;
+    }
+    return first;
+}
+
+template <class T> bool streamToData(std::string_view str, T& data)
+{
+    std::istringstream ss{ string(str) };
     ss.imbue(std::locale::classic());
-    if (!(ss >> data))
+    return bool(ss >> data);
+}
+
+// Parse an integer from the start of the given string.  As with formatted
+// stream input, any characters following the parsed value are ignored.
+template <class T> bool parseScalar(std::string_view str, enable_if_integral_t<T>& data)
+{
+    const char* last = str.data() + str.size();
+    return std::from_chars(skipPrefix(str.data(), last), last, data).ec == std::errc();
+}
+
+// Parse a floating-point value from the start of the given string.  Inputs
+// whose stream interpretation may differ, such as out-of-range values and
+// dangling exponents, are passed to the stream fallback.
+template <class T> bool parseScalar(std::string_view str, enable_if_floating_point_t<T>& data)
+{
+#ifdef MATERIALX_FLOAT_CHARCONV
+    const char* last = str.data() + str.size();
+    const char* first = skipPrefix(str.data(), last);
+    const char* digits = (first != last && *first == '-') ? first + 1 : first;
+    if (digits == last || (!std::isdigit((unsigned char) *digits) && *digits != '.'))
     {
-        throw ExceptionTypeError("Type mismatch in generic stringToData: " + str);
+        return false;
     }
+    std::from_chars_result result = std::from_chars(first, last, data);
+    if (result.ec == std::errc() && (result.ptr == last || (*result.ptr != 'e' && *result.ptr != 'E')))
+    {
+        return true;
+    }
+#endif
+    return streamToData(str, data);
 }
 
-template <> void stringToData(const string& str, bool& data)
+template <class T> void stringToData(std::string_view str, T& data)
+{
+    if (!parseScalar<T>(str, data))
+    {
+        throw ExceptionTypeError("Type mismatch in generic stringToData: " + string(str));
+    }
+}
+
+template <> void stringToData(std::string_view str, bool& data)
 {
     if (str == VALUE_STRING_TRUE)
         data = true;
     else if (str == VALUE_STRING_FALSE)
         data = false;
     else
-        throw ExceptionTypeError("Type mismatch in boolean stringToData: " + str);
+        throw ExceptionTypeError("Type mismatch in boolean stringToData: " + string(str));
 }
 
-template <> void stringToData(const string& str, string& data)
+template <> void stringToData(std::string_view str, string& data)
 {
     data = str;
 }
 
-template <class T> void stringToData(const string& str, enable_if_mx_vector_t<T>& data)
+// Call the given function for each non-empty substring of the given string
+// that is delimited by separator characters, returning the substring count.
+template <class F> size_t forEachToken(std::string_view str, std::string_view sep, F func)
 {
-    StringVec tokens = splitString(str, ARRAY_VALID_SEPARATORS);
-    if (tokens.size() != data.numElements())
-    {
-        throw ExceptionTypeError("Type mismatch in vector stringToData: " + str);
-    }
-    for (size_t i = 0; i < data.numElements(); i++)
+    size_t count = 0;
+    size_t pos = str.find_first_not_of(sep);
+    while (pos != std::string_view::npos)
     {
-        stringToData(tokens[i], data[i]);
+        size_t end = str.find_first_of(sep, pos);
+        func(count++, str.substr(pos, end - pos));
+        pos = str.find_first_not_of(sep, end);
     }
+    return count;
 }
 
-template <class T> void stringToData(const string& str, enable_if_mx_matrix_t<T>& data)
+template <class T> void stringToData(std::string_view str, enable_if_mx_vector_t<T>& data)
 {
-    StringVec tokens = splitString(str, ARRAY_VALID_SEPARATORS);
-    if (tokens.size() != data.numRows() * data.numColumns())
+    size_t count = forEachToken(str, ARRAY_VALID_SEPARATORS, [&data](size_t i, std::string_view token)
     {
-        throw ExceptionTypeError("Type mismatch in matrix stringToData: " + str);
+        if (i < data.numElements())
+        {
+            stringToData(token, data[i]);
+        }
+    });
+    if (count != data.numElements())
+    {
+        throw ExceptionTypeError("Type mismatch in vector stringToData: " + string(str));
     }
-    for (size_t i = 0; i < data.numRows(); i++)
+}
+
+template <class T> void stringToData(std::string_view str, enable_if_mx_matrix_t<T>& data)
+{
+    size_t count = forEachToken(str, ARRAY_VALID_SEPARATORS, [&data](size_t i, std::string_view token)
     {
-        for (size_t j = 0; j < data.numColumns(); j++)
+        if (i < data.numRows() * data.numColumns())
         {
-            stringToData(tokens[i * data.numRows() + j], data[i][j]);
+            stringToData(token, data[i / data.numColumns()][i % data.numColumns()]);
         }
+    });
+    if (count != data.numRows() * data.numColumns())
+    {
+        throw ExceptionTypeError("Type mismatch in matrix stringToData: " + string(str));
     }
 }
 
-template <class T> void stringToData(const string& str, enable_if_std_vector_t<T>& data)
+template <class T> void stringToData(std::string_view str, enable_if_std_vector_t<T>& data)
 {
     // This code path parses an array of arbitrary substrings, so we split the string
     // in a fashion that preserves substrings with internal spaces.
-    const string COMMA_SEPARATOR = ",";
-    for (const string& token : splitString(str, COMMA_SEPARATOR))
+    const char COMMA_SEPARATOR = ',';
+    const char SPACE = ' ';
+    forEachToken(str, std::string_view(&COMMA_SEPARATOR, 1), [&data, SPACE](size_t, std::string_view token)
     {
+        size_t start = token.find_first_not_of(SPACE);
+        size_t end = token.find_last_not_of(SPACE);
+        token = (start == std::string_view::npos) ? std::string_view() : token.substr(start, end + 1 - start);
+
         typename T::value_type val;
-        stringToData(trimSpaces(token), val);
+        stringToData(token, val);
         data.push_back(val);
-    }
+    });
 }
 
-template <class T> void dataToString(const T& data, string& str)
+template <class T> void streamFromData(const T& data, string& str)
 {
-    std::stringstream ss;
+    std::ostringstream ss;
     ss.imbue(std::locale::classic());
 
     // Set float format and precision for the stream
@@ -112,26 +197,59 @@ template <class T> void dataToString(const T& data, string& str)
     ss.precision(Value::getFloatPrecision());
 
     ss << data;
-    str = ss.str();
+    str += ss.str();
+}
+
+// Append the given integer to a string.
+template <class T> void formatScalar(enable_if_integral_t<T> data, string& str)
+{
+    char buffer[32];
+    std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), data);
+    str.append(buffer, result.ptr);
+}
+
+// Append the given floating-point value to a string, matching the output of
+// a stream with the current float format and precision.
+template <class T> void formatScalar(enable_if_floating_point_t<T> data, string& str)
+{
+#ifdef MATERIALX_FLOAT_CHARCONV
+    const Value::FloatFormat fmt = Value::getFloatFormat();
+    const std::chars_format charsFormat = (fmt == Value::FloatFormatFixed) ? std::chars_format::fixed :
+                                          (fmt == Value::FloatFormatScientific) ? std::chars_format::scientific :
+                                          std::chars_format::general;
+    const int precision = Value::getFloatPrecision() < 0 ? 6 : Value::getFloatPrecision();
+
+    char buffer[128];
+    std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), data, charsFormat, precision);
+    if (result.ec == std::errc())
+    {
+        str.append(buffer, result.ptr);
+        return;
+    }
+#endif
+    streamFromData(data, str);
+}
+
+template <class T> void dataToString(const T& data, string& str)
+{
+    formatScalar<T>(data, str);
 }
 
 template <> void dataToString(const bool& data, string& str)
 {
-    str = data ? VALUE_STRING_TRUE : VALUE_STRING_FALSE;
+    str += data ? VALUE_STRING_TRUE : VALUE_STRING_FALSE;
 }
 
 template <> void dataToString(const string& data, string& str)
 {
-    str = data;
+    str += data;
 }
 
 template <class T> void dataToString(const enable_if_mx_vector_t<T>& data, string& str)
 {
     for (size_t i = 0; i < data.numElements(); i++)
     {
-        string token;
-        dataToString(data[i], token);
-        str += token;
+        dataToString(data[i], str);
         if (i + 1 < data.numElements())
         {
             str += ARRAY_PREFERRED_SEPARATOR;
@@ -145,9 +263,7 @@ template <class T> void dataToString(const enable_if_mx_matrix_t<T>& data, strin
     {
         for (size_t j = 0; j < data.numColumns(); j++)
         {
-            string token;
-            dataToString(data[i][j], token);
-            str += token;
+            dataToString(data[i][j], str);
             if (i + 1 < data.numRows() ||
                 j + 1 < data.numColumns())
             {
@@ -161,9 +277,7 @@ template <class T> void dataToString(const enable_if_std_vector_t<T>& data, stri
 {
     for (size_t i = 0; i < data.size(); i++)
     {
-        string token;
-        dataToString<typename T::value_type>(data[i], token);
-        str += token;
+        dataToString<typename T::value_type>(data[i], str);
         if (i + 1 < data.size())
         {
             str += ARRAY_PREFERRED_SEPARATOR;
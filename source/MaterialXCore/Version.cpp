@@ -5,6 +5,8 @@
 
 #include <MaterialXCore/Document.h>
 
+#include <chrono>
+
 MATERIALX_NAMESPACE_BEGIN
 
 namespace
@@ -60,19 +62,27 @@ void copyInputWithBindings(NodePtr sourceNode, const string& sourceInputName,
 
 } // anonymous namespace
 
-void Document::upgradeVersion()
+void Document::upgradeVersion(const UpgradeVersionCallback& callback)
 {
+    // Documents at the current version require no traversal.
     std::pair<int, int> documentVersion = getVersionIntegers();
     std::pair<int, int> expectedVersion(MATERIALX_MAJOR_VERSION, MATERIALX_MINOR_VERSION);
     if (documentVersion >= expectedVersion)
     {
         return;
     }
-    int majorVersion = documentVersion.first;
-    int minorVersion = documentVersion.second;
+
+    // Register each upgrade pass with the versions that it converts between.
+    struct UpgradePass
+    {
+        std::pair<int, int> fromVersion;
+        std::pair<int, int> toVersion;
+        std::function<void()> apply;
+    };
+    vector<UpgradePass> passes;
 
     // Upgrade from v1.22 to v1.23
-    if (majorVersion == 1 && minorVersion == 22)
+    passes.push_back({ { 1, 22 }, { 1, 23 }, [this]()
     {
         for (ElementPtr elem : traverseTree())
         {
@@ -81,12 +91,15 @@ void Document::upgradeVersion()
                 elem->setAttribute(TypedElement::TYPE_ATTRIBUTE, getTypeString<Vector3>());
             }
         }
-        minorVersion = 23;
-    }
+    } });
 
     // Upgrade from v1.23 to v1.24
-    if (majorVersion == 1 && minorVersion == 23)
+    passes.push_back({ { 1, 23 }, { 1, 24 }, [this]()
     {
+        for (ElementPtr child : getChildrenOfType<Element>("assign"))
+        {
+            changeChildCategory(child, "materialassign");
+        }
         for (ElementPtr elem : traverseTree())
         {
             if (elem->getCategory() == "shader" && elem->hasAttribute("shadername"))
@@ -94,16 +107,11 @@ void Document::upgradeVersion()
                 elem->setAttribute(NodeDef::NODE_ATTRIBUTE, elem->getAttribute("shadername"));
                 elem->removeAttribute("shadername");
             }
-            for (ElementPtr child : getChildrenOfType<Element>("assign"))
-            {
-                elem->changeChildCategory(child, "materialassign");
-            }
         }
-        minorVersion = 24;
-    }
+    } });
 
     // Upgrade from v1.24 to v1.25
-    if (majorVersion == 1 && minorVersion == 24)
+    passes.push_back({ { 1, 24 }, { 1, 25 }, [this]()
     {
         for (ElementPtr elem : traverseTree())
         {
@@ -113,11 +121,10 @@ void Document::upgradeVersion()
                 elem->removeAttribute("graphname");
             }
         }
-        minorVersion = 25;
-    }
+    } });
 
     // Upgrade from v1.25 to v1.26
-    if (majorVersion == 1 && minorVersion == 25)
+    passes.push_back({ { 1, 25 }, { 1, 26 }, [this]()
     {
         for (ElementPtr elem : traverseTree())
         {
@@ -130,11 +137,10 @@ void Document::upgradeVersion()
                 }
             }
         }
-        minorVersion = 26;
-    }
+    } });
 
     // Upgrade from v1.26 to v1.34
-    if (majorVersion == 1 && minorVersion == 26)
+    passes.push_back({ { 1, 26 }, { 1, 34 }, [this]()
     {
         // Upgrade elements in place.
         for (ElementPtr elem : traverseTree())
@@ -279,12 +285,10 @@ void Document::upgradeVersion()
             GeomInfoPtr udimSetInfo = addGeomInfo();
             udimSetInfo->setGeomPropValue(UDIM_SET_PROPERTY, udimSetString, getTypeString<StringVec>());
         }
-
-        minorVersion = 34;
-    }
+    } });
 
     // Upgrade from v1.34 to v1.35
-    if (majorVersion == 1 && minorVersion == 34)
+    passes.push_back({ { 1, 34 }, { 1, 35 }, [this]()
     {
         for (ElementPtr elem : traverseTree())
         {
@@ -304,11 +308,10 @@ void Document::upgradeVersion()
                 matAssign->setMaterial(matAssign->getName());
             }
         }
-        minorVersion = 35;
-    }
+    } });
 
     // Upgrade from v1.35 to v1.36
-    if (majorVersion == 1 && minorVersion == 35)
+    passes.push_back({ { 1, 35 }, { 1, 36 }, [this]()
     {
         for (ElementPtr elem : traverseTree())
         {
@@ -373,11 +376,10 @@ void Document::upgradeVersion()
                 }
             }
         }
-        minorVersion = 36;
-    }
+    } });
 
     // Upgrade from 1.36 to 1.37
-    if (majorVersion == 1 && minorVersion == 36)
+    passes.push_back({ { 1, 36 }, { 1, 37 }, [this]()
     {
         // Convert type attributes to child outputs.
         for (NodeDefPtr nodeDef : getNodeDefs())
@@ -569,12 +571,10 @@ void Document::upgradeVersion()
         {
             node->getParent()->removeChild(node->getName());
         }
-
-        minorVersion = 37;
-    }
+    } });
 
     // Upgrade from 1.37 to 1.38
-    if (majorVersion == 1 && minorVersion == 37)
+    passes.push_back({ { 1, 37 }, { 1, 38 }, [this]()
     {
         // Convert color2 types to vector2
         const StringMap COLOR2_CHANNEL_MAP = { { "r", "x" }, { "a", "y" } };
@@ -970,12 +970,10 @@ void Document::upgradeVersion()
                 }
             }
         }
-
-        minorVersion = 38;
-    }
+    } });
 
     // Upgrade from 1.38 to 1.39
-    if (majorVersion == 1 && minorVersion == 38)
+    passes.push_back({ { 1, 38 }, { 1, 39 }, [this]()
     {
         const std::unordered_map<char, size_t> CHANNEL_INDEX_MAP =
         {
@@ -1152,7 +1150,7 @@ void Document::upgradeVersion()
                 InputPtr which = node->getInput("which");
                 if (which && which->hasValue())
                 {
-                    auto whichValue = which->getValue();
+                    ConstValuePtr whichValue = which->getConstValue();
                     if (whichValue->isA<int>() && whichValue->asA<int>() >= 5)
                     {
                         which->setValue(0);
@@ -1396,14 +1394,30 @@ void Document::upgradeVersion()
         {
             node->getParent()->removeChild(node->getName());
         }
+    } });
 
-        minorVersion = 39;
+    // Apply the chain of passes that begins at the document version, reporting
+    // the duration of each pass to the optional callback.
+    std::pair<int, int> upgradedVersion = documentVersion;
+    for (const UpgradePass& pass : passes)
+    {
+        if (pass.fromVersion != upgradedVersion)
+        {
+            continue;
+        }
+        auto startTime = std::chrono::steady_clock::now();
+        pass.apply();
+        upgradedVersion = pass.toVersion;
+        if (callback)
+        {
+            std::chrono::duration<double> duration = std::chrono::steady_clock::now() - startTime;
+            callback(pass.fromVersion.first, pass.fromVersion.second, duration.count());
+        }
     }
 
-    std::pair<int, int> upgradedVersion(majorVersion, minorVersion);
     if (upgradedVersion == expectedVersion)
     {
-        setVersionIntegers(majorVersion, minorVersion);
+        setVersionIntegers(upgradedVersion.first, upgradedVersion.second);
     }
 }
 
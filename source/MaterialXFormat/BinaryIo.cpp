@@ -0,0 +1,396 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <MaterialXFormat/BinaryIo.h>
+
+#include <MaterialXFormat/Environ.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include <cstring>
+#include <fstream>
+
+MATERIALX_NAMESPACE_BEGIN
+
+const string MTLX_BINARY_EXTENSION = "mtlxb";
+const unsigned int MTLX_BINARY_FORMAT_VERSION = 1;
+
+namespace
+{
+
+// The snapshot layout is a fixed header, followed by a table of unique
+// strings, followed by a pre-order sequence of element records.  Each
+// element record stores the string indices of its category, name and source
+// URI, its attribute count and attribute key/value indices, and its child
+// count.  All integers are stored as 32-bit little-endian values.
+const char BINARY_MAGIC[] = { 'M', 'T', 'L', 'X', 'S', 'N', 'A', 'P' };
+
+class BinaryWriter
+{
+  public:
+    void writeDocument(ConstDocumentPtr doc)
+    {
+        writeElement(doc);
+    }
+
+    string getResult() const
+    {
+        string header(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+        appendUint(header, MTLX_BINARY_FORMAT_VERSION);
+        appendUint(header, (uint32_t) _strings.size());
+        for (const string* str : _strings)
+        {
+            appendUint(header, (uint32_t) str->size());
+            header += *str;
+        }
+        return header + _records;
+    }
+
+  private:
+    void writeElement(ConstElementPtr elem)
+    {
+        appendUint(_records, getStringIndex(elem->getCategory()));
+        appendUint(_records, getStringIndex(elem->getName()));
+        appendUint(_records, getStringIndex(elem->getSourceUri()));
+        size_t attrCount = elem->getAttributeCount();
+        appendUint(_records, (uint32_t) attrCount);
+        for (size_t i = 0; i < attrCount; i++)
+        {
+            appendUint(_records, getStringIndex(elem->getAttributeName(i)));
+            appendUint(_records, getStringIndex(elem->getAttributeValue(i)));
+        }
+        const ElementVec& children = elem->getChildren();
+        appendUint(_records, (uint32_t) children.size());
+        for (const ElementPtr& child : children)
+        {
+            writeElement(child);
+        }
+    }
+
+    uint32_t getStringIndex(const string& str)
+    {
+        auto it = _stringIndices.find(str);
+        if (it != _stringIndices.end())
+        {
+            return it->second;
+        }
+        uint32_t index = (uint32_t) _strings.size();
+        it = _stringIndices.emplace(str, index).first;
+        _strings.push_back(&it->first);
+        return index;
+    }
+
+    static void appendUint(string& buffer, uint32_t value)
+    {
+        char bytes[4] = { (char) (value & 0xff), (char) ((value >> 8) & 0xff),
+                          (char) ((value >> 16) & 0xff), (char) ((value >> 24) & 0xff) };
+        buffer.append(bytes, sizeof(bytes));
+    }
+
+  private:
+    std::unordered_map<string, uint32_t> _stringIndices;
+    vector<const string*> _strings;
+    string _records;
+};
+
+class BinaryReader
+{
+  public:
+    BinaryReader(const char* buffer, size_t size) :
+        _pos(buffer),
+        _end(buffer + size)
+    {
+    }
+
+    void readDocument(DocumentPtr doc)
+    {
+        if ((size_t) (_end - _pos) < sizeof(BINARY_MAGIC) ||
+            std::memcmp(_pos, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0)
+        {
+            throw ExceptionParseError("Invalid binary document header.");
+        }
+        _pos += sizeof(BINARY_MAGIC);
+        if (readUint() != MTLX_BINARY_FORMAT_VERSION)
+        {
+            throw ExceptionParseError("Unsupported binary document version.");
+        }
+
+        // Read the string table.
+        uint32_t stringCount = readUint();
+        if (stringCount > (size_t) (_end - _pos) / 4)
+        {
+            throw ExceptionParseError("Invalid binary document string table.");
+        }
+        _strings.reserve(stringCount);
+        for (uint32_t i = 0; i < stringCount; i++)
+        {
+            uint32_t length = readUint();
+            _strings.emplace_back(readBytes(length), length);
+        }
+
+        // Read the element tree.
+        if (readString() != Document::CATEGORY)
+        {
+            throw ExceptionParseError("No root MaterialX element found.");
+        }
+        readString();
+        readContent(doc, 1);
+        if (_pos != _end)
+        {
+            throw ExceptionParseError("Unexpected data at end of binary document.");
+        }
+    }
+
+  private:
+    // Read the content of an element record into the given element.  If
+    // the element is null, then the record is skipped.
+    void readContent(ElementPtr elem, int depth)
+    {
+        const string& sourceUri = readString();
+        if (elem && !sourceUri.empty())
+        {
+            elem->setSourceUri(sourceUri);
+        }
+
+        uint32_t attrCount = readUint();
+        if (elem)
+        {
+            elem->reserveContent(0, attrCount);
+        }
+        for (uint32_t i = 0; i < attrCount; i++)
+        {
+            const string& attrName = readString();
+            const string& attrValue = readString();
+            if (elem)
+            {
+                elem->setAttribute(attrName, attrValue);
+            }
+        }
+
+        uint32_t childCount = readUint();
+        if (elem)
+        {
+            elem->reserveContent(childCount, 0);
+        }
+        for (uint32_t i = 0; i < childCount; i++)
+        {
+            const string& category = readString();
+            const string& name = readString();
+
+            // Enforce maximum tree depth.
+            if (depth >= MAX_XML_TREE_DEPTH)
+            {
+                throw ExceptionParseError("Maximum tree depth exceeded.");
+            }
+
+            // Skip duplicate elements, matching the behavior of XML reads.
+            ElementPtr child;
+            if (elem && !elem->getChild(name))
+            {
+                child = elem->addChildOfCategory(category, name);
+            }
+            readContent(child, depth + 1);
+        }
+    }
+
+    uint32_t readUint()
+    {
+        const unsigned char* bytes = (const unsigned char*) readBytes(4);
+        return (uint32_t) bytes[0] | ((uint32_t) bytes[1] << 8) |
+               ((uint32_t) bytes[2] << 16) | ((uint32_t) bytes[3] << 24);
+    }
+
+    const string& readString()
+    {
+        uint32_t index = readUint();
+        if (index >= _strings.size())
+        {
+            throw ExceptionParseError("Invalid binary document string index.");
+        }
+        return _strings[index];
+    }
+
+    const char* readBytes(size_t count)
+    {
+        if ((size_t) (_end - _pos) < count)
+        {
+            throw ExceptionParseError("Unexpected end of binary document.");
+        }
+        const char* bytes = _pos;
+        _pos += count;
+        return bytes;
+    }
+
+  private:
+    const char* _pos;
+    const char* _end;
+    StringVec _strings;
+};
+
+// A read-only view of a file's contents, memory-mapped where supported.
+class MappedFile
+{
+  public:
+    explicit MappedFile(const FilePath& filename)
+    {
+#if defined(_WIN32)
+        _file = CreateFileA(filename.asString().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (_file == INVALID_HANDLE_VALUE)
+        {
+            throw ExceptionFileMissing("Failed to open file for reading: " + filename.asString());
+        }
+        LARGE_INTEGER fileSize;
+        if (GetFileSizeEx(_file, &fileSize) && fileSize.QuadPart > 0)
+        {
+            _size = (size_t) fileSize.QuadPart;
+            _mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (_mapping)
+            {
+                _data = (const char*) MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+            }
+        }
+#else
+        int fd = open(filename.asString().c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw ExceptionFileMissing("Failed to open file for reading: " + filename.asString());
+        }
+        struct stat sb;
+        if (fstat(fd, &sb) == 0 && sb.st_size > 0)
+        {
+            _size = (size_t) sb.st_size;
+            void* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED)
+            {
+                _data = (const char*) data;
+                _mapped = true;
+            }
+        }
+        close(fd);
+#endif
+
+        // Fall back to reading the file into memory.
+        if (!_data && _size > 0)
+        {
+            std::ifstream file(filename.asString(), std::ios::in | std::ios::binary);
+            _buffer.resize(_size);
+            if (!file.read(&_buffer[0], (std::streamsize) _size))
+            {
+                throw ExceptionFileMissing("Failed to read file: " + filename.asString());
+            }
+            _data = _buffer.data();
+        }
+    }
+
+    ~MappedFile()
+    {
+#if defined(_WIN32)
+        if (_data && _buffer.empty())
+        {
+            UnmapViewOfFile(_data);
+        }
+        if (_mapping)
+        {
+            CloseHandle(_mapping);
+        }
+        if (_file != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(_file);
+        }
+#else
+        if (_mapped)
+        {
+            munmap((void*) _data, _size);
+        }
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* getData() const
+    {
+        return _data;
+    }
+
+    size_t getSize() const
+    {
+        return _size;
+    }
+
+  private:
+    const char* _data = nullptr;
+    size_t _size = 0;
+    string _buffer;
+#if defined(_WIN32)
+    HANDLE _file = INVALID_HANDLE_VALUE;
+    HANDLE _mapping = nullptr;
+#else
+    bool _mapped = false;
+#endif
+};
+
+} // anonymous namespace
+
+//
+// Reading
+//
+
+void readFromBinaryBuffer(DocumentPtr doc, const char* buffer, size_t size)
+{
+    // Cached lookup data is rebuilt on demand after the element tree is
+    // constructed, rather than being maintained for each new element.
+    doc->invalidateCache();
+
+    BinaryReader reader(buffer, size);
+    reader.readDocument(doc);
+}
+
+void readFromBinaryFile(DocumentPtr doc, FilePath filename, FileSearchPath searchPath)
+{
+    searchPath.append(getEnvironmentPath());
+    filename = searchPath.find(filename);
+
+    MappedFile file(filename);
+    readFromBinaryBuffer(doc, file.getData(), file.getSize());
+}
+
+//
+// Writing
+//
+
+string writeToBinaryString(DocumentPtr doc)
+{
+    BinaryWriter writer;
+    writer.writeDocument(doc);
+    return writer.getResult();
+}
+
+void writeToBinaryFile(DocumentPtr doc, const FilePath& filename)
+{
+    std::ofstream ofs(filename.asString(), std::ios::out | std::ios::binary);
+    if (!ofs)
+    {
+        throw Exception("Failed to open file for writing: " + filename.asString());
+    }
+    const string buffer = writeToBinaryString(doc);
+    ofs.write(buffer.data(), (std::streamsize) buffer.size());
+    ofs.close();
+    if (!ofs)
+    {
+        throw Exception("Failed to write file: " + filename.asString());
+    }
+}
+
+MATERIALX_NAMESPACE_END
@@ -0,0 +1,73 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef MATERIALX_BINARYIO_H
+#define MATERIALX_BINARYIO_H
+
+/// @file
+/// Support for binary document snapshots
+
+#include <MaterialXCore/Library.h>
+
+#include <MaterialXCore/Document.h>
+
+#include <MaterialXFormat/Export.h>
+#include <MaterialXFormat/File.h>
+#include <MaterialXFormat/XmlIo.h>
+
+MATERIALX_NAMESPACE_BEGIN
+
+extern MX_FORMAT_API const string MTLX_BINARY_EXTENSION;
+
+/// The version of the binary snapshot format.  Snapshots written with a
+/// different format version cannot be read.
+extern MX_FORMAT_API const unsigned int MTLX_BINARY_FORMAT_VERSION;
+
+/// @name Read Functions
+/// @{
+
+/// Read a Document from the given binary snapshot buffer.
+///
+/// A binary snapshot stores the complete element tree of a document, including
+/// the source URI of each element, so that a document loaded from XML and
+/// written as a snapshot is restored with identical content.  XInclude
+/// references and version upgrades are resolved when a snapshot is written,
+/// and are not reprocessed when it is read.
+///
+/// @param doc The Document into which data is read.
+/// @param buffer The buffer from which data is read.
+/// @param size The size of the buffer in bytes.
+/// @throws ExceptionParseError if the snapshot cannot be parsed.
+MX_FORMAT_API void readFromBinaryBuffer(DocumentPtr doc, const char* buffer, size_t size);
+
+/// Read a Document from the given binary snapshot file.  Where supported by
+/// the platform, the file is memory-mapped rather than copied into memory.
+/// @param doc The Document into which data is read.
+/// @param filename The filename from which data is read.
+/// @param searchPath An optional sequence of file paths that will be applied
+///    in order when searching for the given file.
+/// @throws ExceptionParseError if the snapshot cannot be parsed.
+/// @throws ExceptionFileMissing if the file cannot be opened.
+MX_FORMAT_API void readFromBinaryFile(DocumentPtr doc, FilePath filename, FileSearchPath searchPath = FileSearchPath());
+
+/// @}
+/// @name Write Functions
+/// @{
+
+/// Write a Document as a binary snapshot to a new string, returned by value.
+/// @param doc The Document to be written.
+/// @return The output string, returned by value
+MX_FORMAT_API string writeToBinaryString(DocumentPtr doc);
+
+/// Write a Document as a binary snapshot to the given filename.
+/// @param doc The Document to be written.
+/// @param filename The filename to which data is written.
+MX_FORMAT_API void writeToBinaryFile(DocumentPtr doc, const FilePath& filename);
+
+/// @}
+
+MATERIALX_NAMESPACE_END
+
+#endif
@@ -8,6 +8,7 @@
 #include <MaterialXFormat/Environ.h>
 
 #include <MaterialXCore/Exception.h>
+#include <MaterialXCore/Util.h>
 
 #if defined(_WIN32)
     #define WIN32_LEAN_AND_MEAN
@@ -179,6 +180,32 @@ bool FilePath::isDirectory() const
 #endif
 }
 
+size_t FilePath::getModificationStamp() const
+{
+    size_t stamp = 0;
+#if defined(_WIN32)
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExA(asString().c_str(), GetFileExInfoStandard, &data))
+        return 0;
+    hashCombine(stamp, data.ftLastWriteTime.dwLowDateTime);
+    hashCombine(stamp, data.ftLastWriteTime.dwHighDateTime);
+    hashCombine(stamp, data.nFileSizeLow);
+    hashCombine(stamp, data.nFileSizeHigh);
+#else
+    struct stat sb;
+    if (stat(asString().c_str(), &sb))
+        return 0;
+    hashCombine(stamp, (int64_t) sb.st_size);
+    hashCombine(stamp, (int64_t) sb.st_mtime);
+    #if defined(__APPLE__)
+    hashCombine(stamp, (int64_t) sb.st_mtimespec.tv_nsec);
+    #else
+    hashCombine(stamp, (int64_t) sb.st_mtim.tv_nsec);
+    #endif
+#endif
+    return stamp ? stamp : 1;
+}
+
 FilePathVec FilePath::getFilesInDirectory(const string& extension) const
 {
     FilePathVec files;
@@ -187,6 +187,11 @@ class MX_FORMAT_API FilePath
     /// Return true if the given path is a directory on the file system.
     bool isDirectory() const;
 
+    /// Return a stamp that changes whenever the file at the given path is
+    /// modified, combining its size and modification time, or zero if the
+    /// path does not exist.
+    size_t getModificationStamp() const;
+
     /// Return a vector of all files in the given directory with the given extension.
     FilePathVec getFilesInDirectory(const string& extension) const;
 
@@ -0,0 +1,292 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <MaterialXFormat/FileCache.h>
+
+#include <algorithm>
+
+MATERIALX_NAMESPACE_BEGIN
+
+namespace
+{
+
+const string VALID_SEPARATORS = "/\\";
+
+// Return true if the given normalized path strings are equal, or if one
+// names a location within the other.
+bool isRelatedPath(const string& a, const string& b)
+{
+    const string& shorter = a.size() < b.size() ? a : b;
+    const string& longer = a.size() < b.size() ? b : a;
+    if (longer.compare(0, shorter.size(), shorter) != 0)
+    {
+        return false;
+    }
+    return longer.size() == shorter.size() ||
+           shorter.empty() ||
+           VALID_SEPARATORS.find(longer[shorter.size()]) != string::npos ||
+           VALID_SEPARATORS.find(shorter.back()) != string::npos;
+}
+
+} // anonymous namespace
+
+//
+// FileSearchCacheStatistics methods
+//
+
+FileSearchCacheStatistics::FileSearchCacheStatistics() :
+    hits(0),
+    misses(0),
+    syscalls(0),
+    syscallsAvoided(0)
+{
+}
+
+//
+// FileSearchCache methods
+//
+
+FileSearchCache::FileSearchCache(bool directorySnapshots) :
+    _directorySnapshots(directorySnapshots)
+{
+}
+
+bool FileSearchCache::exists(const FilePath& path)
+{
+    const string key = path.getNormalized().asString();
+    {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        auto it = _exists.find(key);
+        if (it != _exists.end())
+        {
+            recordHit(1);
+            return it->second;
+        }
+    }
+
+    bool result = path.exists();
+    recordMiss(1);
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    _exists[key] = result;
+    return result;
+}
+
+size_t FileSearchCache::getModificationStamp(const FilePath& path)
+{
+    const string key = path.getNormalized().asString();
+    {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        auto it = _stamps.find(key);
+        if (it != _stamps.end())
+        {
+            recordHit(1);
+            return it->second;
+        }
+    }
+
+    size_t result = path.getModificationStamp();
+    recordMiss(1);
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    _stamps[key] = result;
+    return result;
+}
+
+FilePath FileSearchCache::find(const FilePath& filename, const FileSearchPath& searchPath, const FilePath& localPath)
+{
+    if ((searchPath.isEmpty() && localPath.isEmpty()) || filename.isEmpty() || filename.isAbsolute())
+    {
+        return filename;
+    }
+
+    string key = filename.asString();
+    key += '\n';
+    key += localPath.asString();
+    key += '\n';
+    key += searchPath.asString();
+    {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        auto it = _finds.find(key);
+        if (it != _finds.end())
+        {
+            recordHit(it->second.candidates.size());
+            return it->second.result;
+        }
+    }
+
+    FindEntry entry;
+    entry.result = filename;
+    auto checkPath = [&entry, &filename](const FilePath& path)
+    {
+        FilePath combined = path / filename;
+        entry.candidates.push_back(combined.getNormalized().asString());
+        if (combined.exists())
+        {
+            entry.result = combined;
+            return true;
+        }
+        return false;
+    };
+    if (localPath.isEmpty() || !checkPath(localPath))
+    {
+        for (const FilePath& path : searchPath)
+        {
+            if (checkPath(path))
+            {
+                break;
+            }
+        }
+    }
+
+    recordMiss(entry.candidates.size());
+    FilePath result = entry.result;
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    _finds[key] = std::move(entry);
+    return result;
+}
+
+FilePathVec FileSearchCache::getFilesInDirectory(const FilePath& dir, const string& extension)
+{
+    // The extension follows a character that is not valid in paths, so that
+    // listings of files never collide with listings of subdirectories.
+    const string key = dir.getNormalized().asString() + '\n' + extension;
+    {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        if (!_directorySnapshots)
+        {
+            lock.unlock();
+            recordMiss(1);
+            return dir.getFilesInDirectory(extension);
+        }
+        auto it = _listings.find(key);
+        if (it != _listings.end())
+        {
+            recordHit(it->second.syscalls);
+            return it->second.paths;
+        }
+    }
+
+    ListingEntry entry{ dir.getFilesInDirectory(extension), 1 };
+    recordMiss(entry.syscalls);
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    _listings[key] = entry;
+    return entry.paths;
+}
+
+FilePathVec FileSearchCache::getSubDirectories(const FilePath& dir)
+{
+    // Each directory in the hierarchy is both checked and listed.
+    const string key = dir.getNormalized().asString();
+    {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        if (!_directorySnapshots)
+        {
+            lock.unlock();
+            FilePathVec dirs = dir.getSubDirectories();
+            recordMiss(std::max<size_t>(dirs.size() * 2, 1));
+            return dirs;
+        }
+        auto it = _listings.find(key);
+        if (it != _listings.end())
+        {
+            recordHit(it->second.syscalls);
+            return it->second.paths;
+        }
+    }
+
+    ListingEntry entry;
+    entry.paths = dir.getSubDirectories();
+    entry.syscalls = std::max<size_t>(entry.paths.size() * 2, 1);
+    recordMiss(entry.syscalls);
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    _listings[key] = entry;
+    return entry.paths;
+}
+
+void FileSearchCache::setDirectorySnapshots(bool enable)
+{
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    _directorySnapshots = enable;
+    if (!enable)
+    {
+        _listings.clear();
+    }
+}
+
+bool FileSearchCache::getDirectorySnapshots() const
+{
+    std::shared_lock<std::shared_mutex> lock(_mutex);
+    return _directorySnapshots;
+}
+
+void FileSearchCache::invalidate()
+{
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    _exists.clear();
+    _stamps.clear();
+    _finds.clear();
+    _listings.clear();
+}
+
+void FileSearchCache::invalidate(const FilePath& path)
+{
+    // Results for the given path, for paths within it, and for the
+    // directories that contain it are discarded.
+    const string root = path.getNormalized().asString();
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    for (auto it = _exists.begin(); it != _exists.end();)
+    {
+        it = isRelatedPath(it->first, root) ? _exists.erase(it) : std::next(it);
+    }
+    for (auto it = _stamps.begin(); it != _stamps.end();)
+    {
+        it = isRelatedPath(it->first, root) ? _stamps.erase(it) : std::next(it);
+    }
+    for (auto it = _finds.begin(); it != _finds.end();)
+    {
+        bool related = false;
+        for (const string& candidate : it->second.candidates)
+        {
+            if (isRelatedPath(candidate, root))
+            {
+                related = true;
+                break;
+            }
+        }
+        it = related ? _finds.erase(it) : std::next(it);
+    }
+    for (auto it = _listings.begin(); it != _listings.end();)
+    {
+        const string dir = it->first.substr(0, it->first.find('\n'));
+        it = isRelatedPath(dir, root) ? _listings.erase(it) : std::next(it);
+    }
+}
+
+FileSearchCacheStatistics FileSearchCache::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(_statsMutex);
+    return _stats;
+}
+
+void FileSearchCache::resetStatistics()
+{
+    std::lock_guard<std::mutex> lock(_statsMutex);
+    _stats = FileSearchCacheStatistics();
+}
+
+void FileSearchCache::recordHit(size_t syscallsAvoided)
+{
+    std::lock_guard<std::mutex> lock(_statsMutex);
+    _stats.hits++;
+    _stats.syscallsAvoided += syscallsAvoided;
+}
+
+void FileSearchCache::recordMiss(size_t syscalls)
+{
+    std::lock_guard<std::mutex> lock(_statsMutex);
+    _stats.misses++;
+    _stats.syscalls += syscalls;
+}
+
+MATERIALX_NAMESPACE_END
@@ -0,0 +1,139 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef MATERIALX_FILECACHE_H
+#define MATERIALX_FILECACHE_H
+
+/// @file
+/// A memoizing cache of file system queries
+
+#include <MaterialXFormat/Export.h>
+
+#include <MaterialXFormat/File.h>
+
+#include <mutex>
+#include <shared_mutex>
+
+MATERIALX_NAMESPACE_BEGIN
+
+/// A shared pointer to a FileSearchCache
+using FileSearchCachePtr = shared_ptr<class FileSearchCache>;
+
+/// @class FileSearchCacheStatistics
+/// Statistics that are gathered by a FileSearchCache.
+class MX_FORMAT_API FileSearchCacheStatistics
+{
+  public:
+    FileSearchCacheStatistics();
+    ~FileSearchCacheStatistics() = default;
+
+    /// The number of queries that were answered from the cache.
+    size_t hits;
+
+    /// The number of queries that required file system calls.
+    size_t misses;
+
+    /// The number of file system calls that were made by cache misses.
+    size_t syscalls;
+
+    /// The number of file system calls that would have been made by cache
+    /// hits, had their queries not been cached.
+    size_t syscallsAvoided;
+};
+
+/// @class FileSearchCache
+/// A memoizing cache of file system queries, for clients that resolve the
+/// same filenames against the same search paths many times.
+///
+/// The results of path existence checks, modification stamps and search path
+/// resolution are cached until they are explicitly invalidated.  If directory
+/// snapshots are enabled, then directory listings are cached as well.
+/// Clients that create, modify, move or delete files in cached locations
+/// should call invalidate to discard the affected results.
+///
+/// All methods of this class may be called from multiple threads.
+class MX_FORMAT_API FileSearchCache
+{
+  public:
+    FileSearchCache(bool directorySnapshots = false);
+    ~FileSearchCache() = default;
+
+    static FileSearchCachePtr create(bool directorySnapshots = false)
+    {
+        return std::make_shared<FileSearchCache>(directorySnapshots);
+    }
+
+    /// Return true if the given path exists on the file system.
+    bool exists(const FilePath& path);
+
+    /// Return the modification stamp of the given path, or zero if the path
+    /// does not exist.
+    size_t getModificationStamp(const FilePath& path);
+
+    /// Given an input filename, return the first combined path that is found
+    /// on the file system, first checking the given local path, if any, and
+    /// then each path in the given search path.  If no combined path is found,
+    /// then the original filename is returned unmodified.  The result matches
+    /// that of FileSearchPath::find for the combined search path.
+    FilePath find(const FilePath& filename, const FileSearchPath& searchPath, const FilePath& localPath = FilePath());
+
+    /// Return a vector of all files in the given directory with the given
+    /// extension.  The listing is cached if directory snapshots are enabled.
+    FilePathVec getFilesInDirectory(const FilePath& dir, const string& extension);
+
+    /// Return a vector of the given directory and all of its nested
+    /// subdirectories.  The listing is cached if directory snapshots are
+    /// enabled.
+    FilePathVec getSubDirectories(const FilePath& dir);
+
+    /// Set whether directory listings are cached.
+    void setDirectorySnapshots(bool enable);
+
+    /// Return true if directory listings are cached.
+    bool getDirectorySnapshots() const;
+
+    /// Discard all cached results.
+    void invalidate();
+
+    /// Discard the cached results that depend on the given path or on any
+    /// path within it.
+    void invalidate(const FilePath& path);
+
+    /// Return the statistics that have been gathered by this cache.
+    FileSearchCacheStatistics getStatistics() const;
+
+    /// Reset the statistics that have been gathered by this cache.
+    void resetStatistics();
+
+  private:
+    struct FindEntry
+    {
+        FilePath result;
+        vector<string> candidates;
+    };
+
+    struct ListingEntry
+    {
+        FilePathVec paths;
+        size_t syscalls;
+    };
+
+    void recordHit(size_t syscallsAvoided);
+    void recordMiss(size_t syscalls);
+
+  private:
+    std::unordered_map<string, bool> _exists;
+    std::unordered_map<string, size_t> _stamps;
+    std::unordered_map<string, FindEntry> _finds;
+    std::unordered_map<string, ListingEntry> _listings;
+    bool _directorySnapshots;
+    FileSearchCacheStatistics _stats;
+    mutable std::shared_mutex _mutex;
+    mutable std::mutex _statsMutex;
+};
+
+MATERIALX_NAMESPACE_END
+
+#endif
@@ -5,9 +5,13 @@
 
 #include <MaterialXFormat/Util.h>
 
+#include <atomic>
+#include <chrono>
+#include <exception>
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <thread>
 
 #if defined(__APPLE__) && defined(BUILD_APPLE_FRAMEWORK)
     #include <dlfcn.h>
@@ -15,6 +19,42 @@
 
 MATERIALX_NAMESPACE_BEGIN
 
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+double getElapsedSeconds(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+} // anonymous namespace
+
+//
+// LibraryLoadOptions methods
+//
+
+LibraryLoadOptions::LibraryLoadOptions() :
+    threadCount(1)
+{
+}
+
+//
+// LibraryLoadStatistics methods
+//
+
+LibraryLoadStatistics::LibraryLoadStatistics() :
+    fileCount(0),
+    readTime(0.0),
+    importTime(0.0)
+{
+}
+
+//
+// Utility functions
+//
+
 string readFile(const FilePath& filePath)
 {
     std::ifstream file(filePath.asString(), std::ios::in);
@@ -88,58 +128,132 @@ StringSet loadLibraries(const FilePathVec& libraryFolders,
                         const FileSearchPath& searchPath,
                         DocumentPtr doc,
                         const StringSet& excludeFiles,
-                        const XmlReadOptions* readOptions)
+                        const XmlReadOptions* readOptions,
+                        const LibraryLoadOptions* loadOptions,
+                        LibraryLoadStatistics* statistics)
 {
     // Append environment path to the specified search path.
     FileSearchPath librarySearchPath = searchPath;
     librarySearchPath.append(getEnvironmentPath());
 
+    // Gather library files in load order.
     StringSet loadedLibraries;
-    if (libraryFolders.empty())
+    FilePathVec libraryFiles;
+    auto gatherLibraryFiles = [&](const FilePath& libraryPath)
     {
-        // No libraries specified so scan in all search paths
-        for (const FilePath& libraryPath : librarySearchPath)
+        for (const FilePath& path : libraryPath.getSubDirectories())
         {
-            for (const FilePath& path : libraryPath.getSubDirectories())
+            for (const FilePath& filename : path.getFilesInDirectory(MTLX_EXTENSION))
             {
-                for (const FilePath& filename : path.getFilesInDirectory(MTLX_EXTENSION))
+                if (!excludeFiles.count(filename))
                 {
-                    if (!excludeFiles.count(filename))
+                    const FilePath& file = path / filename;
+                    if (loadedLibraries.count(file) == 0)
                     {
-                        const FilePath& file = path / filename;
-                        if (loadedLibraries.count(file) == 0)
-                        {
-                            loadLibrary(file, doc, searchPath, readOptions);
-                            loadedLibraries.insert(file.asString());
-                        }
+                        libraryFiles.push_back(file);
+                        loadedLibraries.insert(file.asString());
                     }
                 }
             }
         }
+    };
+    if (libraryFolders.empty())
+    {
+        // No libraries specified so scan in all search paths
+        for (const FilePath& libraryPath : librarySearchPath)
+        {
+            gatherLibraryFiles(libraryPath);
+        }
     }
     else
     {
         // Look for specific library folders in the search paths
         for (const FilePath& libraryName : libraryFolders)
         {
-            FilePath libraryPath = librarySearchPath.find(libraryName);
-            for (const FilePath& path : libraryPath.getSubDirectories())
+            gatherLibraryFiles(librarySearchPath.find(libraryName));
+        }
+    }
+
+    unsigned int threadCount = loadOptions ? loadOptions->threadCount : 1;
+    if (threadCount == 0)
+    {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    threadCount = (unsigned int) std::min((size_t) threadCount, libraryFiles.size());
+
+    double readTime = 0.0;
+    double importTime = 0.0;
+    if (threadCount <= 1)
+    {
+        // Read and import each library in turn.
+        for (const FilePath& file : libraryFiles)
+        {
+            Clock::time_point readStart = Clock::now();
+            DocumentPtr libDoc = createDocument();
+            readFromXmlFile(libDoc, file, searchPath, readOptions);
+            readTime += getElapsedSeconds(readStart);
+
+            Clock::time_point importStart = Clock::now();
+            doc->importLibrary(libDoc);
+            importTime += getElapsedSeconds(importStart);
+        }
+    }
+    else
+    {
+        // Read libraries concurrently into separate documents.
+        Clock::time_point readStart = Clock::now();
+        vector<DocumentPtr> libDocs(libraryFiles.size());
+        vector<std::exception_ptr> readErrors(libraryFiles.size());
+        std::atomic<size_t> nextIndex(0);
+        auto readLibraries = [&]()
+        {
+            for (size_t i = nextIndex++; i < libraryFiles.size(); i = nextIndex++)
             {
-                for (const FilePath& filename : path.getFilesInDirectory(MTLX_EXTENSION))
+                try
                 {
-                    if (!excludeFiles.count(filename))
-                    {
-                        const FilePath& file = path / filename;
-                        if (loadedLibraries.count(file) == 0)
-                        {
-                            loadLibrary(file, doc, searchPath, readOptions);
-                            loadedLibraries.insert(file.asString());
-                        }
-                    }
+                    DocumentPtr libDoc = createDocument();
+                    readFromXmlFile(libDoc, libraryFiles[i], searchPath, readOptions);
+                    libDocs[i] = libDoc;
+                }
+                catch (...)
+                {
+                    readErrors[i] = std::current_exception();
                 }
             }
+        };
+        vector<std::thread> threads;
+        for (unsigned int i = 0; i < threadCount; i++)
+        {
+            threads.emplace_back(readLibraries);
         }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        readTime = getElapsedSeconds(readStart);
+
+        // Import libraries in order, reporting any read errors at the point
+        // where a serial load would have encountered them.
+        Clock::time_point importStart = Clock::now();
+        for (size_t i = 0; i < libraryFiles.size(); i++)
+        {
+            if (readErrors[i])
+            {
+                std::rethrow_exception(readErrors[i]);
+            }
+            doc->importLibrary(libDocs[i]);
+            libDocs[i] = nullptr;
+        }
+        importTime = getElapsedSeconds(importStart);
     }
+
+    if (statistics)
+    {
+        statistics->fileCount = libraryFiles.size();
+        statistics->readTime = readTime;
+        statistics->importTime = importTime;
+    }
+
     return loadedLibraries;
 }
 
@@ -19,6 +19,40 @@
 
 MATERIALX_NAMESPACE_BEGIN
 
+/// @class LibraryLoadOptions
+/// A set of options for controlling the behavior of loadLibraries.
+class MX_FORMAT_API LibraryLoadOptions
+{
+  public:
+    LibraryLoadOptions();
+    ~LibraryLoadOptions() = default;
+
+    /// The number of threads with which library files are read.  Each file is
+    /// read into a separate document, and the resulting documents are imported
+    /// in the same order as a serial load.  A value of zero selects the number
+    /// of hardware threads.  When reading concurrently, any custom XInclude
+    /// read function must be safe to call from multiple threads.  Defaults to 1.
+    unsigned int threadCount;
+};
+
+/// @class LibraryLoadStatistics
+/// Statistics that are gathered by loadLibraries.
+class MX_FORMAT_API LibraryLoadStatistics
+{
+  public:
+    LibraryLoadStatistics();
+    ~LibraryLoadStatistics() = default;
+
+    /// The number of library files that were loaded.
+    size_t fileCount;
+
+    /// The wall-clock time in seconds spent reading library files.
+    double readTime;
+
+    /// The wall-clock time in seconds spent importing library documents.
+    double importTime;
+};
+
 /// Read the given file and return a string containing its contents; if the read is not
 /// successful, then the empty string is returned.
 MX_FORMAT_API string readFile(const FilePath& file);
@@ -44,11 +78,23 @@ MX_FORMAT_API void loadLibrary(const FilePath& file,
 
 /// Load all MaterialX files within the given library folders into a document,
 /// using the given search path to locate the folders on the file system.
+/// @param libraryFolders The library folders to load.  If empty, then all
+///    folders within the search path are loaded.
+/// @param searchPath The search path used to locate library folders.
+/// @param doc The document into which libraries are imported.
+/// @param excludeFiles An optional set of filenames to be skipped.
+/// @param readOptions An optional pointer to an XmlReadOptions object.
+/// @param loadOptions An optional pointer to a LibraryLoadOptions object.
+/// @param statistics An optional pointer to a LibraryLoadStatistics object,
+///    which will be populated with statistics for this load.
+/// @return The set of library files that were loaded.
 MX_FORMAT_API StringSet loadLibraries(const FilePathVec& libraryFolders,
                                       const FileSearchPath& searchPath,
                                       DocumentPtr doc,
                                       const StringSet& excludeFiles = StringSet(),
-                                      const XmlReadOptions* readOptions = nullptr);
+                                      const XmlReadOptions* readOptions = nullptr,
+                                      const LibraryLoadOptions* loadOptions = nullptr,
+                                      LibraryLoadStatistics* statistics = nullptr);
 
 /// Flatten all filenames in the given document, applying string resolvers at the
 /// scope of each element and removing all fileprefix attributes.
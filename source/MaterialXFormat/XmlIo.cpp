@@ -9,6 +9,7 @@
 
 #include <MaterialXCore/Types.h>
 
+#include <cctype>
 #include <cstring>
 #include <fstream>
 #include <sstream>
@@ -41,6 +42,12 @@ void documentToXml(DocumentPtr doc, xml_node& xmlRoot, const XmlWriteOptions* wr
         xml_node xmlNode = elemStack.back().second;
         elemStack.pop_back();
 
+        // Read deferred graph bodies before they are written.
+        if (elem->getCategory() == NodeGraph::CATEGORY)
+        {
+            elem->asA<NodeGraph>()->loadDeferredBody();
+        }
+
         bool writeXIncludeEnable = writeOptions ? writeOptions->writeXIncludeEnable : true;
         ElementPredicate elementPredicate = writeOptions ? writeOptions->elementPredicate : nullptr;
 
@@ -49,10 +56,10 @@ void documentToXml(DocumentPtr doc, xml_node& xmlRoot, const XmlWriteOptions* wr
         {
             xmlNode.append_attribute(Element::NAME_ATTRIBUTE.c_str()) = elem->getName().c_str();
         }
-        for (const string& attrName : elem->getAttributeNames())
+        for (size_t i = 0; i < elem->getAttributeCount(); i++)
         {
-            xml_attribute xmlAttr = xmlNode.append_attribute(attrName.c_str());
-            xmlAttr.set_value(elem->getAttribute(attrName).c_str());
+            xml_attribute xmlAttr = xmlNode.append_attribute(elem->getAttributeName(i).c_str());
+            xmlAttr.set_value(elem->getAttributeValue(i).c_str());
         }
 
         // Create child elements and recurse.
@@ -114,15 +121,36 @@ void documentToXml(DocumentPtr doc, xml_node& xmlRoot, const XmlWriteOptions* wr
 
 void elementFromXml(const xml_node& xmlNode, ElementPtr elem, const XmlReadOptions* readOptions, int depth = 1)
 {
+    // Reserve storage for attributes and children.
+    size_t attributeCount = 0;
+    size_t childCount = 0;
+    for (xml_attribute xmlAttr = xmlNode.first_attribute(); xmlAttr; xmlAttr = xmlAttr.next_attribute())
+    {
+        attributeCount++;
+    }
+    for (xml_node xmlChild = xmlNode.first_child(); xmlChild; xmlChild = xmlChild.next_sibling())
+    {
+        childCount++;
+    }
+    elem->reserveContent(childCount, attributeCount);
+
     // Store attributes in element.
     for (const xml_attribute& xmlAttr : xmlNode.attributes())
     {
-        if (xmlAttr.name() != Element::NAME_ATTRIBUTE)
+        if (std::strcmp(xmlAttr.name(), Element::NAME_ATTRIBUTE.c_str()) != 0)
         {
             elem->setAttribute(xmlAttr.name(), xmlAttr.value());
         }
     }
 
+    // Skip the children of elements rejected by the element predicate.
+    if (depth > 1 && xmlNode.type() == node_element &&
+        readOptions && readOptions->elementPredicate && !readOptions->elementPredicate(elem))
+    {
+        elem->getParent()->removeChild(elem->getName());
+        return;
+    }
+
     // Create child elements and recurse.
     for (const xml_node& xmlChild : xmlNode.children())
     {
@@ -148,7 +176,7 @@ void elementFromXml(const xml_node& xmlNode, ElementPtr elem, const XmlReadOptio
         }
 
         // Create the child element.
-        ElementPtr child = elem->addChildOfCategory(category, name);
+        ElementPtr child = elem->addChildOfCategory(category, std::move(name));
         elementFromXml(xmlChild, child, readOptions, depth + 1);
 
         // Handle the interpretation of XML comments and newlines.
@@ -167,6 +195,55 @@ void elementFromXml(const xml_node& xmlNode, ElementPtr elem, const XmlReadOptio
     }
 }
 
+// Resolve a filename against the given search path and the search path
+// environment variable, as readFromXmlFile does for the files it reads.
+FilePath resolveXmlFilename(const FilePath& filename, FileSearchPath searchPath)
+{
+    searchPath.append(getEnvironmentPath());
+    return searchPath.find(filename);
+}
+
+// Read the library document referenced by an XInclude, returning a null
+// pointer if its contents are provided by the data library of the document.
+DocumentPtr readXInclude(DocumentPtr doc, const string& filename, const FileSearchPath& searchPath, const XmlReadOptions* readOptions,
+                         const XmlReadFunction& readXIncludeFunction, StringSet& libraryUris)
+{
+    const StringVec& parents = readOptions ? readOptions->parentXIncludes : StringVec();
+
+    // Validate XInclude state.
+    if (std::find(parents.begin(), parents.end(), filename) != parents.end())
+    {
+        throw ExceptionParseError("XInclude cycle detected.");
+    }
+    if (parents.size() >= MAX_XINCLUDE_DEPTH)
+    {
+        throw ExceptionParseError("Maximum XInclude depth exceeded.");
+    }
+
+    // Skip files that are provided by the data library.
+    if (readOptions && readOptions->skipDataLibraryXIncludes && doc->hasDataLibrary())
+    {
+        if (libraryUris.empty())
+        {
+            for (const string& uri : doc->getDataLibrary()->getReferencedSourceUris())
+            {
+                libraryUris.insert(resolveXmlFilename(uri, searchPath).getNormalized());
+            }
+        }
+        if (libraryUris.count(resolveXmlFilename(filename, searchPath).getNormalized()))
+        {
+            return nullptr;
+        }
+    }
+
+    // Read the included file into a library document.
+    DocumentPtr library = createDocument();
+    XmlReadOptions xiReadOptions = readOptions ? *readOptions : XmlReadOptions();
+    xiReadOptions.parentXIncludes.push_back(filename);
+    readXIncludeFunction(library, filename, searchPath, &xiReadOptions);
+    return library;
+}
+
 void documentFromXml(DocumentPtr doc, const xml_document& xmlDoc, const FileSearchPath& searchPath, const XmlReadOptions* readOptions)
 {
     xml_node xmlRoot = xmlDoc.child(Document::CATEGORY.c_str());
@@ -175,48 +252,765 @@ void documentFromXml(DocumentPtr doc, const xml_document& xmlDoc, const FileSear
         throw ExceptionParseError("No root MaterialX element found.");
     }
 
+    // Cached lookup data is rebuilt on demand after the element tree is
+    // constructed, rather than being maintained for each new element.
+    doc->invalidateCache();
+
     // Process XInclude directives.
     XmlReadFunction readXIncludeFunction = readOptions ? readOptions->readXIncludeFunction : readFromXmlFile;
     if (readXIncludeFunction)
     {
+        StringSet libraryUris;
         for (const xml_node& xmlChild : xmlRoot.children())
         {
             if (xmlChild.name() == XINCLUDE_TAG)
             {
                 string filename = xmlChild.attribute("href").value();
-                const StringVec& parents = readOptions ? readOptions->parentXIncludes : StringVec();
+                DocumentPtr library = readXInclude(doc, filename, searchPath, readOptions, readXIncludeFunction, libraryUris);
+                doc->importLibrary(library);
+            }
+        }
+    }
+
+    // Build the element tree.
+    elementFromXml(xmlRoot, doc, readOptions);
+
+    // Upgrade version if requested.
+    if (!readOptions || readOptions->upgradeVersion)
+    {
+        doc->upgradeVersion(readOptions ? readOptions->upgradeVersionCallback : nullptr);
+    }
+}
+
+// An event-driven XML reader, which builds elements directly from a stream
+// of parse events rather than from an intermediate XML DOM.  The structure
+// of the resulting documents matches that of documentFromXml.
+class XmlStreamReader
+{
+  public:
+    XmlStreamReader(std::istream& stream, const FilePath& filename = FilePath()) :
+        _stream(stream),
+        _filename(filename),
+        _pos(0),
+        _offset(0)
+    {
+    }
+
+    void readDocument(DocumentPtr doc, const FileSearchPath& searchPath, const XmlReadOptions* readOptions)
+    {
+        _doc = doc;
+        _searchPath = searchPath;
+        _readOptions = readOptions;
+        _readXIncludeFunction = readOptions ? readOptions->readXIncludeFunction : readFromXmlFile;
+        _importIndex = doc->getChildren().size();
+
+        // Cached lookup data is rebuilt on demand after the element tree is
+        // constructed, rather than being maintained for each new element.
+        doc->invalidateCache();
+
+        // Skip the UTF-8 byte order mark.
+        consume("\xEF\xBB\xBF");
+
+        readEvents(false);
+        if (!_rootFound)
+        {
+            throw ExceptionParseError("No root MaterialX element found.");
+        }
+
+        // Upgrade version if requested.
+        if (!readOptions || readOptions->upgradeVersion)
+        {
+            doc->upgradeVersion(readOptions ? readOptions->upgradeVersionCallback : nullptr);
+        }
+    }
+
+    // Read the children of the element whose start tag begins at the current
+    // stream position into the given element, ignoring the attributes of the
+    // start tag.
+    void readElementContent(ElementPtr elem, const XmlReadOptions* readOptions)
+    {
+        _doc = elem->getDocument();
+        _readOptions = readOptions;
+
+        if (get() != '<')
+        {
+            throwParseError("Error parsing start element tag");
+        }
+        _openElements.emplace_back();
+        readName(_openElements[0].tag);
+        if (readAttributes())
+        {
+            return;
+        }
+        int depth = 1;
+        for (ConstElementPtr ancestor = elem; ancestor->getParent(); ancestor = ancestor->getParent())
+        {
+            depth++;
+        }
+        _openElements[0].elem = elem;
+        _openElements[0].depth = depth;
+        _openCount = 1;
+
+        readEvents(true);
+    }
+
+    // Read the deferred body of a graph from the given file offset.
+    static void readDeferredBody(NodeGraphPtr graph, const FilePath& filename, size_t offset, const XmlReadOptions* readOptions)
+    {
+        std::ifstream stream(filename.asString(), std::ios::in | std::ios::binary);
+        if (!stream || !stream.seekg((std::streamoff) offset))
+        {
+            throw ExceptionFileMissing("Failed to open file for reading: " + filename.asString());
+        }
+        XmlStreamReader reader(stream, filename);
+        reader._offset = offset;
+        reader.readElementContent(graph, readOptions);
+    }
+
+  private:
+    struct OpenElement
+    {
+        string tag;
+        ElementPtr elem;
+        int depth = 0;
+    };
+
+    // Process parse events in document order.  If reading a fragment, then
+    // parsing stops when its outermost element is closed.
+    void readEvents(bool fragment)
+    {
+        while (peek() != EOF)
+        {
+            Element* parent = _openCount ? _openElements[_openCount - 1].elem.get() : nullptr;
+            int depth = _openCount ? _openElements[_openCount - 1].depth : 0;
+            int next = peek(1);
+            if (peek() != '<')
+            {
+                readText(parent, depth);
+            }
+            else if (next != '/' && next != '?' && next != '!')
+            {
+                _pos++;
+                readStartTag(parent, depth);
+            }
+            else if (consume("</"))
+            {
+                readName(_endTag);
+                skipSpace();
+                if (get() != '>')
+                {
+                    throwParseError("Error parsing end element tag");
+                }
+                if (!_openCount || _openElements[_openCount - 1].tag != _endTag)
+                {
+                    throwParseError("Start-end tags mismatch");
+                }
+                _openElements[--_openCount].elem = nullptr;
+                if (fragment && !_openCount)
+                {
+                    return;
+                }
+            }
+            else if (consume("<?"))
+            {
+                readPast("?>", nullptr, "Error parsing document declaration/processing instruction");
+            }
+            else if (consume("<!--"))
+            {
+                string comment;
+                bool readComment = parent && _readOptions && _readOptions->readComments;
+                readPast("-->", readComment ? &comment : nullptr, "Error parsing comment");
+                if (readComment)
+                {
+                    addContentChild(parent, depth, CommentElement::CATEGORY)->setDocString(comment);
+                }
+            }
+            else if (consume("<![CDATA["))
+            {
+                readPast("]]>", nullptr, "Error parsing CDATA section");
+                if (parent)
+                {
+                    addContentChild(parent, depth, EMPTY_STRING);
+                }
+            }
+            else if (consume("<!DOCTYPE"))
+            {
+                if (_openCount)
+                {
+                    throwParseError("Error parsing document type declaration");
+                }
+                skipDoctype();
+            }
+            else
+            {
+                throwParseError("Unrecognized tag");
+            }
+        }
+        if (_openCount)
+        {
+            throwParseError("Start-end tags mismatch");
+        }
+    }
 
-                // Validate XInclude state.
-                if (std::find(parents.begin(), parents.end(), filename) != parents.end())
+    void readStartTag(Element* parent, int depth)
+    {
+        // Read the tag into the next open element record, reusing its storage.
+        size_t tagOffset = _offset + _pos - 1;
+        if (_openElements.size() == _openCount)
+        {
+            _openElements.emplace_back();
+        }
+        OpenElement& openElement = _openElements[_openCount];
+        const string& tag = openElement.tag;
+        readName(openElement.tag);
+        if (tag.empty())
+        {
+            throwParseError("Unrecognized tag");
+        }
+        bool selfClosing = readAttributes();
+
+        // Create the element, or leave it null if its subtree is to be skipped.
+        ElementPtr elem;
+        if (!_openCount)
+        {
+            if (!_rootFound && tag == Document::CATEGORY)
+            {
+                _rootFound = true;
+                elem = _doc;
+                setAttributes(elem);
+            }
+        }
+        else if (tag == XINCLUDE_TAG)
+        {
+            if (parent == _doc.get() && _readXIncludeFunction)
+            {
+                importXInclude(getAttributeValue("href"));
+            }
+        }
+        else if (parent)
+        {
+            const string& name = getAttributeValue(Element::NAME_ATTRIBUTE);
+            if (!parent->getChild(name))
+            {
+                if (depth >= MAX_XML_TREE_DEPTH)
                 {
-                    throw ExceptionParseError("XInclude cycle detected.");
+                    throw ExceptionParseError("Maximum tree depth exceeded.");
                 }
-                if (parents.size() >= MAX_XINCLUDE_DEPTH)
+                elem = parent->addChildOfCategory(tag, name);
+                setAttributes(elem);
+                if (_readOptions && _readOptions->elementPredicate && !_readOptions->elementPredicate(elem))
                 {
-                    throw ExceptionParseError("Maximum XInclude depth exceeded.");
+                    parent->removeChild(elem->getName());
+                    elem = nullptr;
                 }
+                else if (parent == _doc.get() && canDeferBodies())
+                {
+                    if (tag == Implementation::CATEGORY && elem->hasAttribute(Implementation::NODE_GRAPH_ATTRIBUTE))
+                    {
+                        _implementationGraphs.insert(elem->getAttribute(Implementation::NODE_GRAPH_ATTRIBUTE));
+                    }
+                    else if (!selfClosing && tag == NodeGraph::CATEGORY &&
+                             (elem->hasAttribute(InterfaceElement::NODE_DEF_ATTRIBUTE) || _implementationGraphs.count(elem->getName())))
+                    {
+                        deferBody(elem->asA<NodeGraph>(), tagOffset);
+                        elem = nullptr;
+                    }
+                }
+            }
+        }
 
-                // Read the included file into a library document.
-                DocumentPtr library = createDocument();
-                XmlReadOptions xiReadOptions = readOptions ? *readOptions : XmlReadOptions();
-                xiReadOptions.parentXIncludes.push_back(filename);
-                readXIncludeFunction(library, filename, searchPath, &xiReadOptions);
+        if (!selfClosing)
+        {
+            openElement.elem = elem;
+            openElement.depth = depth + 1;
+            _openCount++;
+        }
+    }
 
-                // Import the library document.
-                doc->importLibrary(library);
+    // Read the attributes of a start tag, returning true if the tag is
+    // self-closing.
+    bool readAttributes()
+    {
+        _attributeCount = 0;
+        while (true)
+        {
+            skipSpace();
+            if (peek() == '/' && peek(1) == '>')
+            {
+                _pos += 2;
+                return true;
+            }
+            if (peek() == '>')
+            {
+                _pos++;
+                return false;
+            }
+            if (_attributes.size() == _attributeCount)
+            {
+                _attributes.emplace_back();
+            }
+            std::pair<string, string>& attr = _attributes[_attributeCount];
+            readName(attr.first);
+            skipSpace();
+            if (attr.first.empty() || get() != '=')
+            {
+                throwParseError("Error parsing element attribute");
             }
+            skipSpace();
+            int quote = get();
+            if (quote != '"' && quote != '\'')
+            {
+                throwParseError("Error parsing element attribute");
+            }
+            readAttributeValue(quote, attr.second);
+            _attributeCount++;
         }
     }
 
-    // Build the element tree.
-    elementFromXml(xmlRoot, doc, readOptions);
+    // Return true if graph bodies in this document may be deferred.  Only the
+    // bodies of graph implementations are deferred, identified by a nodedef
+    // attribute or by a preceding implementation element, and bodies are read
+    // immediately in documents that require a version upgrade.
+    bool canDeferBodies() const
+    {
+        if (!_readOptions || !_readOptions->deferNodeGraphBodies || _filename.isEmpty())
+        {
+            return false;
+        }
+        return !_readOptions->upgradeVersion ||
+               _doc->getVersionIntegers() == std::make_pair(MATERIALX_MAJOR_VERSION, MATERIALX_MINOR_VERSION);
+    }
 
-    // Upgrade version if requested.
-    if (!readOptions || readOptions->upgradeVersion)
+    // Record the location of a graph body, to be read on first access.
+    void deferBody(NodeGraphPtr graph, size_t offset)
     {
-        doc->upgradeVersion();
+        if (!_deferredReadOptions)
+        {
+            _deferredReadOptions = std::make_shared<const XmlReadOptions>(*_readOptions);
+        }
+        FilePath filename = _filename;
+        std::shared_ptr<const XmlReadOptions> readOptions = _deferredReadOptions;
+        graph->setDeferredBody([filename, offset, readOptions](NodeGraphPtr target)
+        {
+            readDeferredBody(target, filename, offset, readOptions.get());
+        });
     }
-}
+
+    void readText(Element* parent, int depth)
+    {
+        size_t lineCount = 0;
+        while (isSpace(peek()))
+        {
+            while (_pos < _buffer.size() && (_buffer[_pos] == ' ' || _buffer[_pos] == '\t' || _buffer[_pos] == '\n'))
+            {
+                lineCount += _buffer[_pos++] == '\n';
+            }
+            if (isSpace(peek()) && get() == '\n')
+            {
+                lineCount++;
+            }
+        }
+        if (parent && _readOptions && _readOptions->readNewlines)
+        {
+            for (size_t i = 1; i < lineCount; i++)
+            {
+                addContentChild(parent, depth, NewlineElement::CATEGORY);
+            }
+        }
+        if (peek() == EOF || peek() == '<')
+        {
+            return;
+        }
+
+        // Character data is represented as a child with an empty category.
+        while (peek() != EOF && peek() != '<')
+        {
+            _pos = std::min(_buffer.find('<', _pos), _buffer.size());
+        }
+        if (parent)
+        {
+            addContentChild(parent, depth, EMPTY_STRING);
+        }
+    }
+
+    // Import an XInclude reference, placing its elements after those of
+    // any previous XIncludes.  Elements that have already been read from
+    // the document are replaced by included elements of the same name, as
+    // XIncludes take precedence regardless of their position.
+    void importXInclude(const string& filename)
+    {
+        DocumentPtr library = readXInclude(_doc, filename, _searchPath, _readOptions, _readXIncludeFunction, _libraryUris);
+        if (!library)
+        {
+            return;
+        }
+        if (_doc->getChildren().size() == _importIndex)
+        {
+            _doc->importLibrary(library);
+            _importIndex = _doc->getChildren().size();
+            return;
+        }
+        for (ElementPtr child : library->getChildren())
+        {
+            const string childName = child->getQualifiedName(child->getName());
+            if (_doc->getChildIndex(childName) >= (int) _importIndex)
+            {
+                _doc->removeChild(childName);
+            }
+        }
+        size_t childCount = _doc->getChildren().size();
+        _doc->importLibrary(library);
+        for (size_t i = childCount; i < _doc->getChildren().size(); i++)
+        {
+            _doc->setChildIndex(_doc->getChildren()[i]->getName(), (int) _importIndex++);
+        }
+    }
+
+    ElementPtr addContentChild(Element* parent, int depth, const string& category)
+    {
+        if (depth >= MAX_XML_TREE_DEPTH)
+        {
+            throw ExceptionParseError("Maximum tree depth exceeded.");
+        }
+        return parent->addChildOfCategory(category, parent->createValidChildName("1"));
+    }
+
+    void setAttributes(ElementPtr elem)
+    {
+        elem->reserveContent(0, _attributeCount);
+        for (size_t i = 0; i < _attributeCount; i++)
+        {
+            if (_attributes[i].first != Element::NAME_ATTRIBUTE)
+            {
+                elem->setAttribute(_attributes[i].first, _attributes[i].second);
+            }
+        }
+    }
+
+    const string& getAttributeValue(const string& attrName) const
+    {
+        for (size_t i = 0; i < _attributeCount; i++)
+        {
+            if (_attributes[i].first == attrName)
+            {
+                return _attributes[i].second;
+            }
+        }
+        return EMPTY_STRING;
+    }
+
+    void readName(string& name)
+    {
+        name.clear();
+        while (peek() != EOF)
+        {
+            size_t start = _pos;
+            while (_pos < _buffer.size() && !isNameDelimiter(_buffer[_pos]))
+            {
+                _pos++;
+            }
+            name.append(_buffer, start, _pos - start);
+            if (_pos < _buffer.size())
+            {
+                break;
+            }
+        }
+    }
+
+    // Read an attribute value, expanding character references and converting
+    // whitespace characters to spaces.
+    void readAttributeValue(int quote, string& value)
+    {
+        value.clear();
+        while (true)
+        {
+            // Append the span of characters that require no conversion.
+            size_t start = _pos;
+            while (_pos < _buffer.size() && _buffer[_pos] != quote && _buffer[_pos] != '&' && !isSpace(_buffer[_pos]))
+            {
+                _pos++;
+            }
+            value.append(_buffer, start, _pos - start);
+
+            int c = get();
+            if (c == EOF)
+            {
+                throwParseError("Error parsing element attribute");
+            }
+            if (c == quote)
+            {
+                return;
+            }
+            if (c == '&')
+            {
+                readReference(value);
+            }
+            else if (isSpace(c))
+            {
+                value += ' ';
+            }
+            else
+            {
+                value += (char) c;
+            }
+        }
+    }
+
+    // Read a character reference following an ampersand.  Unrecognized
+    // references are preserved as text.
+    void readReference(string& value)
+    {
+        if (consume("lt;"))
+        {
+            value += '<';
+        }
+        else if (consume("gt;"))
+        {
+            value += '>';
+        }
+        else if (consume("amp;"))
+        {
+            value += '&';
+        }
+        else if (consume("apos;"))
+        {
+            value += '\'';
+        }
+        else if (consume("quot;"))
+        {
+            value += '"';
+        }
+        else if (peek() == '#')
+        {
+            bool hex = peek(1) == 'x';
+            size_t i = hex ? 2 : 1;
+            unsigned long code = 0;
+            for (int c = peek(i); std::isxdigit(c) && (hex || std::isdigit(c)) && code <= 0x10ffff; c = peek(++i))
+            {
+                code = code * (hex ? 16 : 10) + (unsigned long) (std::isdigit(c) ? c - '0' : (std::tolower(c) - 'a' + 10));
+            }
+            if (peek(i) != ';' || i == (hex ? 2u : 1u) || code > 0x10ffff)
+            {
+                value += '&';
+                return;
+            }
+            _pos += i + 1;
+            appendUtf8(value, code);
+        }
+        else
+        {
+            value += '&';
+        }
+    }
+
+    static void appendUtf8(string& str, unsigned long code)
+    {
+        if (code < 0x80)
+        {
+            str += (char) code;
+        }
+        else if (code < 0x800)
+        {
+            str += (char) (0xc0 | (code >> 6));
+            str += (char) (0x80 | (code & 0x3f));
+        }
+        else if (code < 0x10000)
+        {
+            str += (char) (0xe0 | (code >> 12));
+            str += (char) (0x80 | ((code >> 6) & 0x3f));
+            str += (char) (0x80 | (code & 0x3f));
+        }
+        else
+        {
+            str += (char) (0xf0 | (code >> 18));
+            str += (char) (0x80 | ((code >> 12) & 0x3f));
+            str += (char) (0x80 | ((code >> 6) & 0x3f));
+            str += (char) (0x80 | (code & 0x3f));
+        }
+    }
+
+    // Read characters up to and including the given terminator, optionally
+    // storing the characters that precede it.
+    void readPast(const char* terminator, string* text, const char* error)
+    {
+        while (!consume(terminator))
+        {
+            int c = get();
+            if (c == EOF)
+            {
+                throwParseError(error);
+            }
+            if (text)
+            {
+                *text += (char) c;
+            }
+        }
+    }
+
+    void skipDoctype()
+    {
+        int nesting = 1;
+        while (nesting)
+        {
+            int c = get();
+            if (c == EOF)
+            {
+                throwParseError("Error parsing document type declaration");
+            }
+            if (c == '"' || c == '\'')
+            {
+                while (get() != c)
+                {
+                    if (peek() == EOF)
+                    {
+                        throwParseError("Error parsing document type declaration");
+                    }
+                }
+            }
+            else if (c == '<')
+            {
+                nesting++;
+            }
+            else if (c == '>')
+            {
+                nesting--;
+            }
+        }
+    }
+
+    void skipSpace()
+    {
+        while (isSpace(peek()))
+        {
+            _pos++;
+        }
+    }
+
+    static bool isSpace(int c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    static bool isNameDelimiter(char c)
+    {
+        return isSpace(c) || c == '/' || c == '>' || c == '<' || c == '=';
+    }
+
+    //
+    // Character input
+    //
+
+    // Return true if at least the given number of characters are buffered,
+    // reading from the stream as needed.
+    bool fill(size_t count)
+    {
+        while (_buffer.size() - _pos < count)
+        {
+            _offset += _pos;
+            _buffer.erase(0, _pos);
+            _pos = 0;
+
+            size_t size = _buffer.size();
+            _buffer.resize(size + STREAM_CHUNK_SIZE);
+            _stream.read(&_buffer[size], (std::streamsize) STREAM_CHUNK_SIZE);
+            _buffer.resize(size + (size_t) _stream.gcount());
+            if (_buffer.size() == size)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int peek(size_t ahead = 0)
+    {
+        if (_pos + ahead < _buffer.size())
+        {
+            return (unsigned char) _buffer[_pos + ahead];
+        }
+        return fill(ahead + 1) ? (unsigned char) _buffer[_pos + ahead] : EOF;
+    }
+
+    // Return the next character, normalizing line endings to newlines.
+    int get()
+    {
+        int c = peek();
+        if (c == EOF)
+        {
+            return c;
+        }
+        _pos++;
+        if (c == '\r')
+        {
+            if (peek() == '\n')
+            {
+                _pos++;
+            }
+            c = '\n';
+        }
+        return c;
+    }
+
+    // Consume the given string if it matches the upcoming characters.
+    bool consume(const char* str)
+    {
+        size_t length = std::strlen(str);
+        if (!fill(length) || _buffer.compare(_pos, length, str) != 0)
+        {
+            return false;
+        }
+        _pos += length;
+        return true;
+    }
+
+    [[noreturn]] void throwParseError(const string& desc) const
+    {
+        string message = "XML parse error";
+        if (!_filename.isEmpty())
+        {
+            message += " in " + _filename.asString();
+        }
+        message += " (" + desc + " at character " + std::to_string(_offset + _pos) + ")";
+        throw ExceptionParseError(message);
+    }
+
+  private:
+    static const size_t STREAM_CHUNK_SIZE = 64 * 1024;
+
+    std::istream& _stream;
+    FilePath _filename;
+    string _buffer;
+    size_t _pos;
+    size_t _offset;
+
+    DocumentPtr _doc;
+    FileSearchPath _searchPath;
+    const XmlReadOptions* _readOptions = nullptr;
+    XmlReadFunction _readXIncludeFunction;
+    StringSet _libraryUris;
+    size_t _importIndex = 0;
+    bool _rootFound = false;
+    std::shared_ptr<const XmlReadOptions> _deferredReadOptions;
+    StringSet _implementationGraphs;
+
+    // Storage for open elements and attributes is reused across tags.
+    vector<OpenElement> _openElements;
+    size_t _openCount = 0;
+    vector<std::pair<string, string>> _attributes;
+    size_t _attributeCount = 0;
+    string _endTag;
+};
+
+// A read-only stream buffer over a null-terminated character buffer.
+class CharBufferStreamBuf : public std::streambuf
+{
+  public:
+    explicit CharBufferStreamBuf(const char* buffer)
+    {
+        char* begin = const_cast<char*>(buffer);
+        setg(begin, begin, begin + std::strlen(buffer));
+    }
+};
 
 void validateParseResult(const xml_parse_result& result, const FilePath& filename = FilePath())
 {
@@ -271,7 +1065,10 @@ XmlReadOptions::XmlReadOptions() :
     readComments(false),
     readNewlines(false),
     upgradeVersion(true),
-    readXIncludeFunction(readFromXmlFile)
+    skipDataLibraryXIncludes(false),
+    readXIncludeFunction(readFromXmlFile),
+    streamingRead(false),
+    deferNodeGraphBodies(false)
 {
 }
 
@@ -292,6 +1089,15 @@ void readFromXmlBuffer(DocumentPtr doc, const char* buffer, FileSearchPath searc
 {
     searchPath.append(getEnvironmentPath());
 
+    if (readOptions && readOptions->streamingRead)
+    {
+        CharBufferStreamBuf streamBuf(buffer);
+        std::istream stream(&streamBuf);
+        XmlStreamReader reader(stream);
+        reader.readDocument(doc, searchPath, readOptions);
+        return;
+    }
+
     xml_document xmlDoc;
     xml_parse_result result = xmlDoc.load_string(buffer, getParseOptions(readOptions));
     validateParseResult(result);
@@ -303,6 +1109,13 @@ void readFromXmlStream(DocumentPtr doc, std::istream& stream, FileSearchPath sea
 {
     searchPath.append(getEnvironmentPath());
 
+    if (readOptions && readOptions->streamingRead)
+    {
+        XmlStreamReader reader(stream);
+        reader.readDocument(doc, searchPath, readOptions);
+        return;
+    }
+
     xml_document xmlDoc;
     xml_parse_result result = xmlDoc.load(stream, getParseOptions(readOptions));
     validateParseResult(result);
@@ -312,12 +1125,24 @@ void readFromXmlStream(DocumentPtr doc, std::istream& stream, FileSearchPath sea
 
 void readFromXmlFile(DocumentPtr doc, FilePath filename, FileSearchPath searchPath, const XmlReadOptions* readOptions)
 {
+    filename = resolveXmlFilename(filename, searchPath);
     searchPath.append(getEnvironmentPath());
-    filename = searchPath.find(filename);
 
+    std::ifstream stream;
     xml_document xmlDoc;
-    xml_parse_result result = xmlDoc.load_file(filename.asString().c_str(), getParseOptions(readOptions));
-    validateParseResult(result, filename);
+    if (readOptions && (readOptions->streamingRead || readOptions->deferNodeGraphBodies))
+    {
+        stream.open(filename.asString(), std::ios::in | std::ios::binary);
+        if (!stream)
+        {
+            throw ExceptionFileMissing("Failed to open file for reading: " + filename.asString());
+        }
+    }
+    else
+    {
+        xml_parse_result result = xmlDoc.load_file(filename.asString().c_str(), getParseOptions(readOptions));
+        validateParseResult(result, filename);
+    }
 
     // Store the source URI of the document.
     FilePath sourcePath = (readOptions && !readOptions->parentXIncludes.empty()) ?
@@ -332,6 +1157,12 @@ void readFromXmlFile(DocumentPtr doc, FilePath filename, FileSearchPath searchPa
     }
     searchPath.prepend(sourcePath.getParentPath());
 
+    if (stream.is_open())
+    {
+        XmlStreamReader reader(stream, filename);
+        reader.readDocument(doc, searchPath, readOptions);
+        return;
+    }
     documentFromXml(doc, xmlDoc, searchPath, readOptions);
 }
 
@@ -49,10 +49,50 @@ class MX_FORMAT_API XmlReadOptions
     /// to the current version.  Defaults to true.
     bool upgradeVersion;
 
+    /// If provided, this function will be invoked after each version upgrade
+    /// pass applied to a document or its XIncludes, with the version upgraded
+    /// from and the duration of the pass.  Defaults to an empty function.
+    UpgradeVersionCallback upgradeVersionCallback;
+
+    /// If true, then XInclude references to files whose contents are already
+    /// present in the data library of the target document will be skipped,
+    /// with their elements being accessed through the data library rather
+    /// than copied into the document.  Since skipped references are not
+    /// recorded in the document, they will not be written as XIncludes.
+    /// Defaults to false.
+    bool skipDataLibraryXIncludes;
+
     /// If provided, this function will be invoked when an XInclude reference
     /// needs to be read into a document.  Defaults to readFromXmlFile.
     XmlReadFunction readXIncludeFunction;
 
+    /// If true, then documents will be read by an event-driven parser that
+    /// builds elements directly from the XML stream, rather than from an
+    /// intermediate XML DOM, reducing the peak memory required to read large
+    /// documents.  Only UTF-8 input is supported in this mode.  Defaults to
+    /// false.
+    bool streamingRead;
+
+    /// If provided, this function will be invoked for each element after its
+    /// attributes have been read.  Elements for which it returns false are
+    /// removed from the document, and their children are skipped without
+    /// being read.  Defaults to nullptr.
+    ElementPredicate elementPredicate;
+
+    /// If true, then the child elements of nodegraph implementations in files
+    /// will not be read with the rest of the document.  Graphs are considered
+    /// implementations if they reference a nodedef, or are referenced by a
+    /// preceding implementation element.  Each graph records the
+    /// location of its body within the file, which is read on first access
+    /// to the children of the graph, or when the document is frozen.  Files are
+    /// read with the streaming reader when this option is enabled, and must
+    /// remain unchanged while graph bodies are deferred.  Since reading a
+    /// body modifies the document, a document with deferred bodies must only
+    /// be accessed from one thread at a time until it is frozen.  Bodies are
+    /// read immediately in documents that require a version upgrade.
+    /// Defaults to false.
+    bool deferNodeGraphBodies;
+
     /// The vector of parent XIncludes at the scope of the current document.
     /// Defaults to an empty vector.
     StringVec parentXIncludes;
@@ -717,7 +717,7 @@ ShaderNodeImplPtr GlslShaderGenerator::getImplementation(const NodeDef& nodedef,
     const string& name = implElement->getName();
 
     // Check if it's created and cached already.
-    ShaderNodeImplPtr impl = context.findNodeImplementation(name);
+    ShaderNodeImplPtr impl = context.findNodeImplementation(*implElement);
     if (impl)
     {
         return impl;
@@ -767,7 +767,7 @@ ShaderNodeImplPtr GlslShaderGenerator::getImplementation(const NodeDef& nodedef,
     impl->initialize(*implElement, context);
 
     // Cache it.
-    context.addNodeImplementation(name, impl);
+    context.addNodeImplementation(*implElement, impl);
 
     return impl;
 }
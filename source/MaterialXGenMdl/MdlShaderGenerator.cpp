@@ -349,7 +349,7 @@ ShaderNodeImplPtr MdlShaderGenerator::getImplementation(const NodeDef& nodedef,
     const string& name = implElement->getName();
 
     // Check if it's created and cached already.
-    ShaderNodeImplPtr impl = context.findNodeImplementation(name);
+    ShaderNodeImplPtr impl = context.findNodeImplementation(*implElement);
     if (impl)
     {
         return impl;
@@ -416,7 +416,7 @@ ShaderNodeImplPtr MdlShaderGenerator::getImplementation(const NodeDef& nodedef,
     impl->initialize(*implElement, context);
 
     // Cache it.
-    context.addNodeImplementation(name, impl);
+    context.addNodeImplementation(*implElement, impl);
 
     return impl;
 }
@@ -44,11 +44,15 @@ void LightCompoundNodeMsl::createVariables(const ShaderNode&, GenContext& contex
     ShaderStage& ps = shader.getStage(Stage::PIXEL);
     VariableBlock& lightData = ps.getUniformBlock(HW::LIGHT_DATA);
 
-    // Create all light uniforms
+    // Create all light uniforms.  Each shader receives its own ports, since
+    // the generator renames them during code emission.
     for (size_t i = 0; i < _lightUniforms.size(); ++i)
     {
-        ShaderPort* u = const_cast<ShaderPort*>(_lightUniforms[i]);
-        lightData.add(u->getSelf());
+        const ShaderPort* u = _lightUniforms[i];
+        if (!lightData.find(u->getName()))
+        {
+            lightData.add(u->getType(), u->getName());
+        }
     }
 
     const MslShaderGenerator& shadergen = static_cast<const MslShaderGenerator&>(context.getShaderGenerator());
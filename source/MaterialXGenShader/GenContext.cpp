@@ -4,10 +4,44 @@
 //
 
 #include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/ColorManagementSystem.h>
 #include <MaterialXGenShader/ShaderGenerator.h>
+#include <MaterialXGenShader/UnitSystem.h>
+
+#include <MaterialXCore/Util.h>
 
 MATERIALX_NAMESPACE_BEGIN
 
+namespace
+{
+
+void hashGenOptions(size_t& hash, const GenOptions& options)
+{
+    hashCombine(hash, (int) options.shaderInterfaceType);
+    hashCombine(hash, options.fileTextureVerticalFlip);
+    hashCombine(hash, options.targetColorSpaceOverride);
+    hashCombine(hash, options.targetDistanceUnit);
+    hashCombine(hash, options.addUpstreamDependencies);
+    hashCombine(hash, options.libraryPrefix.asString());
+    hashCombine(hash, options.emitColorTransforms);
+    hashCombine(hash, options.optimizeShaderGraph);
+    hashCombine(hash, options.hwTransparency);
+    hashCombine(hash, (int) options.hwSpecularEnvironmentMethod);
+    hashCombine(hash, (int) options.hwDirectionalAlbedoMethod);
+    hashCombine(hash, (int) options.hwTransmissionRenderMethod);
+    hashCombine(hash, options.hwSrgbEncodeOutput);
+    hashCombine(hash, options.hwWriteDepthMoments);
+    hashCombine(hash, options.hwShadowMap);
+    hashCombine(hash, options.hwAmbientOcclusion);
+    hashCombine(hash, options.hwMaxActiveLightSources);
+    hashCombine(hash, options.hwNormalizeUdimTexCoords);
+    hashCombine(hash, options.hwWriteAlbedoTable);
+    hashCombine(hash, options.hwWriteEnvPrefilter);
+    hashCombine(hash, options.hwImplicitBitangents);
+}
+
+} // anonymous namespace
+
 //
 // GenContext methods
 //
@@ -40,17 +74,91 @@ GenContext::GenContext(ShaderGeneratorPtr sg) :
     _applicationVariableHandler = nullptr;
 }
 
+FilePath GenContext::resolveSourceFile(const FilePath& filename, const FilePath& localPath) const
+{
+    if (_fileSearchCache)
+    {
+        return _fileSearchCache->find(filename, _sourceCodeSearchPath, localPath).getNormalized();
+    }
+
+    // Check the local path before the registered search path, without
+    // building a combined search path.
+    if (!localPath.isEmpty() && !filename.isEmpty() && !filename.isAbsolute())
+    {
+        FilePath combined = localPath / filename;
+        if (combined.exists())
+        {
+            return combined.getNormalized();
+        }
+    }
+    return _sourceCodeSearchPath.find(filename).getNormalized();
+}
+
 void GenContext::addNodeImplementation(const string& name, ShaderNodeImplPtr impl)
 {
     _nodeImpls[name] = impl;
 }
 
+void GenContext::addNodeImplementation(const InterfaceElement& implElement, ShaderNodeImplPtr impl)
+{
+    // If another context registered this implementation first, then the
+    // registered implementation is cached instead.
+    const string& name = implElement.getName();
+    _nodeImpls[name] = _nodeImplRegistry ? _nodeImplRegistry->add(name, getRegistryKey(implElement), impl) : impl;
+}
+
 ShaderNodeImplPtr GenContext::findNodeImplementation(const string& name) const
 {
     auto it = _nodeImpls.find(name);
     return it != _nodeImpls.end() ? it->second : nullptr;
 }
 
+ShaderNodeImplPtr GenContext::findNodeImplementation(const InterfaceElement& implElement) const
+{
+    const string& name = implElement.getName();
+    ShaderNodeImplPtr impl = findNodeImplementation(name);
+    if (impl || !_nodeImplRegistry)
+    {
+        return impl;
+    }
+
+    // Adopt an implementation that was initialized by another context,
+    // caching it locally to avoid further registry lookups.
+    impl = _nodeImplRegistry->find(name, getRegistryKey(implElement));
+    if (impl)
+    {
+        _nodeImpls[name] = impl;
+    }
+    return impl;
+}
+
+size_t GenContext::getRegistryKey(const InterfaceElement& implElement) const
+{
+    // Implementation elements of the same name may differ between data
+    // libraries, and source files are resolved relative to their documents.
+    size_t key = getConfigurationHash();
+    hashCombine(key, implElement.getContentHash());
+    hashCombine(key, implElement.getActiveSourceUri());
+    return key;
+}
+
+size_t GenContext::getConfigurationHash() const
+{
+    size_t hash = 0;
+    hashCombine(hash, _sg->getTarget());
+    if (_sg->getColorManagementSystem())
+    {
+        hashCombine(hash, _sg->getColorManagementSystem()->getName());
+    }
+    if (_sg->getUnitSystem())
+    {
+        hashCombine(hash, _sg->getUnitSystem()->getName());
+    }
+    hashGenOptions(hash, _options);
+    hashCombine(hash, _sourceCodeSearchPath.asString());
+    return hash;
+}
+
 void GenContext::getNodeImplementationNames(StringSet& names)
 {
     for (auto it : _nodeImpls)
@@ -109,6 +217,39 @@ void GenContext::getOutputSuffix(const ShaderOutput* output, string& suffix) con
     }
 }
 
+//
+// ShaderNodeImplRegistry methods
+//
+
+ShaderNodeImplPtr ShaderNodeImplRegistry::find(const string& name, size_t key) const
+{
+    std::shared_lock<std::shared_mutex> lock(_mutex);
+    auto it = _impls.find({ name, key });
+    return it != _impls.end() ? it->second : nullptr;
+}
+
+ShaderNodeImplPtr ShaderNodeImplRegistry::add(const string& name, size_t key, ShaderNodeImplPtr impl)
+{
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    return _impls.emplace(std::make_pair(name, key), impl).first->second;
+}
+
+size_t ShaderNodeImplRegistry::size() const
+{
+    std::shared_lock<std::shared_mutex> lock(_mutex);
+    return _impls.size();
+}
+
+void ShaderNodeImplRegistry::clear()
+{
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    _impls.clear();
+}
+
+//
+// ScopedSetVariableName methods
+//
+
 ScopedSetVariableName::ScopedSetVariableName(const string& name, ShaderPort* port) :
     _port(port),
     _oldName(port->getVariable())
@@ -17,12 +17,59 @@
 #include <MaterialXGenShader/ShaderGenerator.h>
 
 #include <MaterialXFormat/File.h>
+#include <MaterialXFormat/FileCache.h>
+
+#include <map>
+#include <shared_mutex>
 
 MATERIALX_NAMESPACE_BEGIN
 
 /// A standard function to allow for handling of application variables for a given node
 using ApplicationVariableHandler = std::function<void(ShaderNode*, GenContext&)>;
 
+/// A shared pointer to a ShaderNodeImplRegistry
+using ShaderNodeImplRegistryPtr = shared_ptr<class ShaderNodeImplRegistry>;
+
+/// @class ShaderNodeImplRegistry
+/// A registry of initialized shader node implementations, which may be shared
+/// by generation contexts on multiple threads.
+///
+/// Implementations are registered by name and by a hash that combines the
+/// configuration of the context that initialized them with the content and
+/// source URI of their implementation element, so contexts with differing
+/// generator targets, options or data libraries may share a registry without
+/// conflict.
+class MX_GENSHADER_API ShaderNodeImplRegistry
+{
+  public:
+    ShaderNodeImplRegistry() = default;
+    ~ShaderNodeImplRegistry() = default;
+
+    static ShaderNodeImplRegistryPtr create()
+    {
+        return std::make_shared<ShaderNodeImplRegistry>();
+    }
+
+    /// Return the implementation with the given name and key hash, or nullptr
+    /// if no such implementation has been registered.
+    ShaderNodeImplPtr find(const string& name, size_t key) const;
+
+    /// Register an implementation with the given name and key hash, and
+    /// return the registered implementation.  If another thread registered
+    /// an implementation first, then that implementation is returned instead.
+    ShaderNodeImplPtr add(const string& name, size_t key, ShaderNodeImplPtr impl);
+
+    /// Return the number of registered implementations.
+    size_t size() const;
+
+    /// Clear all registered implementations.
+    void clear();
+
+  private:
+    std::map<std::pair<string, size_t>, ShaderNodeImplPtr> _impls;
+    mutable std::shared_mutex _mutex;
+};
+
 /// @class GenContext
 /// A context class for shader generation.
 /// Used for thread local storage of data needed during shader generation.
@@ -70,16 +117,30 @@ class MX_GENSHADER_API GenContext
         _sourceCodeSearchPath.append(path);
     }
 
+    /// Return the user search path for finding source code during
+    /// code generation.
+    const FileSearchPath& getSourceCodeSearchPath() const
+    {
+        return _sourceCodeSearchPath;
+    }
+
     /// Resolve a source code filename, first checking the given local path
     /// then checking any file paths registered by the user.
-    FilePath resolveSourceFile(const FilePath& filename, const FilePath& localPath) const
+    FilePath resolveSourceFile(const FilePath& filename, const FilePath& localPath) const;
+
+    /// Set a cache of file system queries to be used when resolving source
+    /// code filenames, which may be shared with other contexts.  Resolved
+    /// filenames are reused until the cache is invalidated by the client.
+    void setFileSearchCache(FileSearchCachePtr cache)
     {
-        FileSearchPath searchPath = _sourceCodeSearchPath;
-        if (!localPath.isEmpty())
-        {
-            searchPath.prepend(localPath);
-        }
-        return searchPath.find(filename).getNormalized();
+        _fileSearchCache = cache;
+    }
+
+    /// Return the cache of file system queries used when resolving source
+    /// code filenames, if any.
+    FileSearchCachePtr getFileSearchCache() const
+    {
+        return _fileSearchCache;
     }
 
     /// Add reserved words that should not be used as
@@ -99,10 +160,42 @@ class MX_GENSHADER_API GenContext
     /// Cache a shader node implementation.
     void addNodeImplementation(const string& name, ShaderNodeImplPtr impl);
 
+    /// Cache a shader node implementation of the given implementation element,
+    /// adding it to the shared registry of this context, if any.
+    void addNodeImplementation(const InterfaceElement& implElement, ShaderNodeImplPtr impl);
+
     /// Find and return a cached shader node implementation,
     /// or return nullptr if no implementation is found.
     ShaderNodeImplPtr findNodeImplementation(const string& name) const;
 
+    /// Find and return a cached shader node implementation of the given
+    /// implementation element, looking it up in the shared registry of this
+    /// context if it is not yet cached, or return nullptr if no
+    /// implementation is found.
+    ShaderNodeImplPtr findNodeImplementation(const InterfaceElement& implElement) const;
+
+    /// Set a registry of node implementations to be shared with other contexts.
+    /// Implementations that are looked up and cached by implementation element
+    /// are found in the registry before being created, and are added to it
+    /// once created.
+    void setNodeImplRegistry(ShaderNodeImplRegistryPtr registry)
+    {
+        _nodeImplRegistry = registry;
+    }
+
+    /// Return the registry of node implementations shared with other
+    /// contexts, if any.
+    ShaderNodeImplRegistryPtr getNodeImplRegistry() const
+    {
+        return _nodeImplRegistry;
+    }
+
+    /// Return a hash of the shader generator target, color management and
+    /// unit systems, generation options and source code search path of
+    /// this context, which together determine how node implementations
+    /// are initialized.
+    size_t getConfigurationHash() const;
+
     /// Get the names of all cached node implementations.
     void getNodeImplementationNames(StringSet& names);
 
@@ -207,12 +300,18 @@ class MX_GENSHADER_API GenContext
   protected:
     GenContext() = delete;
 
+    // Return the key hash of the given implementation element in the shared
+    // registry of node implementations.
+    size_t getRegistryKey(const InterfaceElement& implElement) const;
+
     ShaderGeneratorPtr _sg;
     GenOptions _options;
     FileSearchPath _sourceCodeSearchPath;
+    FileSearchCachePtr _fileSearchCache;
     StringSet _reservedWords;
 
-    std::unordered_map<string, ShaderNodeImplPtr> _nodeImpls;
+    mutable std::unordered_map<string, ShaderNodeImplPtr> _nodeImpls;
+    ShaderNodeImplRegistryPtr _nodeImplRegistry;
     std::unordered_map<string, vector<GenUserDataPtr>> _userData;
     std::unordered_map<const ShaderInput*, string> _inputSuffix;
     std::unordered_map<const ShaderOutput*, string> _outputSuffix;
@@ -81,6 +81,7 @@ class MX_GENSHADER_API GenOptions
         addUpstreamDependencies(true),
         libraryPrefix("libraries"),
         emitColorTransforms(true),
+        optimizeShaderGraph(false),
         hwTransparency(false),
         hwSpecularEnvironmentMethod(SPECULAR_ENVIRONMENT_FIS),
         hwDirectionalAlbedoMethod(DIRECTIONAL_ALBEDO_ANALYTIC),
@@ -134,6 +135,14 @@ class MX_GENSHADER_API GenOptions
     /// system is defined. Defaults to true.
     bool emitColorTransforms;
 
+    /// Enable additional optimization of shader graphs.  Standard library
+    /// math nodes whose inputs are all constant are evaluated during code
+    /// generation, and standard library math and image nodes that share an
+    /// implementation and identical inputs are merged.  The inputs of folded
+    /// and merged nodes are no longer published individually in the shader
+    /// interface.  Defaults to false.
+    bool optimizeShaderGraph;
+
     /// Sets if transparency is needed or not for HW shaders.
     /// If a surface shader has potential of being transparent
     /// this must be set to true, otherwise no transparency
@@ -6,6 +6,7 @@
 #include <MaterialXGenShader/Nodes/SourceCodeNode.h>
 #include <MaterialXGenShader/GenContext.h>
 #include <MaterialXGenShader/ShaderNode.h>
+#include <MaterialXGenShader/SourceFile.h>
 #include <MaterialXGenShader/ShaderStage.h>
 #include <MaterialXGenShader/ShaderGenerator.h>
 #include <MaterialXFormat/Util.h>
@@ -32,7 +33,8 @@ void SourceCodeNode::resolveSourceCode(const InterfaceElement& element, GenConte
 
     FilePath localPath = FilePath(impl.getActiveSourceUri()).getParentPath();
     _sourceFilename = context.resolveSourceFile(impl.getAttribute("file"), localPath);
-    _functionSource = readFile(_sourceFilename);
+    _sourceFile = getSourceFile(_sourceFilename, context.getShaderGenerator().getSyntax(), context.getFileSearchCache().get());
+    _functionSource = _sourceFile ? _sourceFile->getContent() : EMPTY_STRING;
     if (_functionSource.empty())
     {
         throw ExceptionShaderGenError("Failed to get source code from file '" + _sourceFilename.asString() +
@@ -95,8 +97,17 @@ void SourceCodeNode::emitFunctionDefinition(const ShaderNode&, GenContext& conte
     {
         if (!stage.hasSourceDependency(_sourceFilename))
         {
+            // Emit the cached parse of the source file, rather than parsing
+            // its content again for each shader.
             const ShaderGenerator& shadergen = context.getShaderGenerator();
-            shadergen.emitBlock(_functionSource, _sourceFilename, context, stage);
+            if (_sourceFile)
+            {
+                stage.addSourceFile(*_sourceFile, _sourceFilename, context);
+            }
+            else
+            {
+                shadergen.emitBlock(_functionSource, _sourceFilename, context, stage);
+            }
             shadergen.emitLineBreak(stage);
             stage.addSourceDependency(_sourceFilename);
         }
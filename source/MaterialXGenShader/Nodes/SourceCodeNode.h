@@ -7,6 +7,7 @@
 #define MATERIALX_SOURCECODENODE_H
 
 #include <MaterialXGenShader/ShaderNodeImpl.h>
+#include <MaterialXGenShader/SourceFile.h>
 
 #include <MaterialXFormat/File.h>
 
@@ -33,6 +34,7 @@ class MX_GENSHADER_API SourceCodeNode : public ShaderNodeImpl
     string _functionName;
     string _functionSource;
     FilePath _sourceFilename;
+    ConstSourceFilePtr _sourceFile;
 };
 
 MATERIALX_NAMESPACE_END
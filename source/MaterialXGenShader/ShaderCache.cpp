@@ -0,0 +1,698 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <MaterialXGenShader/ShaderCache.h>
+
+#include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/ShaderGenerator.h>
+
+#include <MaterialXFormat/Util.h>
+
+#include <MaterialXCore/Document.h>
+#include <MaterialXCore/Util.h>
+
+#include <cstdio>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
+
+MATERIALX_NAMESPACE_BEGIN
+
+namespace
+{
+
+// Each stored shader is a single file, named by its cache key, containing a
+// fixed header and the full key, followed by the dependencies, attributes and
+// stages of the shader.  Integers are stored as little-endian values, and
+// strings are stored as a 32-bit length followed by their characters.
+const char STORE_MAGIC[] = { 'M', 'T', 'L', 'X', 'S', 'H', 'D', 'R' };
+const uint32_t STORE_FORMAT_VERSION = 2;
+const string STORE_EXTENSION = "mxshader";
+
+// The minimum number of memoized definition graph keys, beyond which keys of
+// expired graphs are pruned.
+const size_t MIN_GRAPH_KEY_LIMIT = 64;
+
+// Append a component to a full key.  Strings are prefixed by their length,
+// so that the boundaries between components are unambiguous.
+void appendKey(string& fullKey, const string& str)
+{
+    fullKey += std::to_string(str.size());
+    fullKey += ':';
+    fullKey += str;
+}
+
+void appendKey(string& fullKey, size_t value)
+{
+    fullKey += std::to_string(value);
+    fullKey += ';';
+}
+
+FilePath getStoreFilename(const FilePath& storePath, size_t key)
+{
+    std::stringstream ss;
+    ss << std::hex << std::setw(16) << std::setfill('0') << (uint64_t) key;
+    return storePath / FilePath(ss.str() + "." + STORE_EXTENSION);
+}
+
+class StoreWriter
+{
+  public:
+    void writeBytes(const char* bytes, size_t count)
+    {
+        _buffer.append(bytes, count);
+    }
+
+    void writeUint(uint64_t value, size_t byteCount = 4)
+    {
+        for (size_t i = 0; i < byteCount; i++)
+        {
+            _buffer += (char) ((value >> (8 * i)) & 0xff);
+        }
+    }
+
+    void writeString(const string& str)
+    {
+        writeUint(str.size());
+        _buffer += str;
+    }
+
+    void writeValue(ValuePtr value)
+    {
+        writeUint(value ? 1 : 0);
+        if (value)
+        {
+            writeString(value->getTypeString());
+            writeString(value->getValueString());
+        }
+    }
+
+    void writeBlock(const VariableBlock& block)
+    {
+        writeUint(block.size());
+        for (size_t i = 0; i < block.size(); i++)
+        {
+            const ShaderPort* port = block[i];
+            writeString(port->getType().getName());
+            writeString(port->getName());
+            writeString(port->getVariable());
+            writeString(port->getSemantic());
+            writeString(port->getPath());
+            writeString(port->getUnit());
+            writeString(port->getColorSpace());
+            writeString(port->getGeomProp());
+            writeUint(port->getFlags());
+            writeValue(port->getValue());
+            const ShaderMetadataVecPtr& metadata = port->getMetadata();
+            writeUint(metadata ? metadata->size() : 0);
+            if (metadata)
+            {
+                for (const ShaderMetadata& data : *metadata)
+                {
+                    writeString(data.name);
+                    writeString(data.type.getName());
+                    writeValue(data.value);
+                }
+            }
+        }
+    }
+
+    void writeBlocks(const VariableBlockMap& blocks)
+    {
+        writeUint(blocks.size());
+        for (const auto& pair : blocks)
+        {
+            writeString(pair.second->getName());
+            writeString(pair.second->getInstance());
+            writeBlock(*pair.second);
+        }
+    }
+
+    const string& getResult() const
+    {
+        return _buffer;
+    }
+
+  private:
+    string _buffer;
+};
+
+class StoreReader
+{
+  public:
+    StoreReader(const string& buffer, GenContext& context) :
+        _pos(buffer.data()),
+        _end(buffer.data() + buffer.size()),
+        _context(context)
+    {
+    }
+
+    bool readHeader(size_t key)
+    {
+        if ((size_t) (_end - _pos) < sizeof(STORE_MAGIC) ||
+            std::memcmp(_pos, STORE_MAGIC, sizeof(STORE_MAGIC)) != 0)
+        {
+            return false;
+        }
+        _pos += sizeof(STORE_MAGIC);
+        return readUint() == STORE_FORMAT_VERSION && readUint(8) == (uint64_t) key;
+    }
+
+    uint64_t readUint(size_t byteCount = 4)
+    {
+        const unsigned char* bytes = (const unsigned char*) readBytes(byteCount);
+        uint64_t value = 0;
+        for (size_t i = 0; i < byteCount; i++)
+        {
+            value |= (uint64_t) bytes[i] << (8 * i);
+        }
+        return value;
+    }
+
+    string readString()
+    {
+        size_t length = (size_t) readUint();
+        return string(readBytes(length), length);
+    }
+
+    ValuePtr readValue()
+    {
+        if (!readUint())
+        {
+            return nullptr;
+        }
+        const string type = readString();
+        const string value = readString();
+        return Value::createValueFromStrings(value, type);
+    }
+
+    void readBlock(VariableBlock& block)
+    {
+        size_t portCount = (size_t) readUint();
+        for (size_t i = 0; i < portCount; i++)
+        {
+            TypeDesc type = _context.getTypeDesc(readString());
+            ShaderPortPtr port = std::make_shared<ShaderPort>(nullptr, type, readString());
+            port->setVariable(readString());
+            port->setSemantic(readString());
+            port->setPath(readString());
+            port->setUnit(readString());
+            port->setColorSpace(readString());
+            port->setGeomProp(readString());
+            port->setFlags((uint32_t) readUint());
+            port->setValue(readValue());
+            size_t metadataCount = (size_t) readUint();
+            if (metadataCount)
+            {
+                ShaderMetadataVecPtr metadata = std::make_shared<ShaderMetadataVec>();
+                for (size_t j = 0; j < metadataCount; j++)
+                {
+                    const string name = readString();
+                    TypeDesc metadataType = _context.getTypeDesc(readString());
+                    metadata->emplace_back(name, metadataType, readValue());
+                }
+                port->setMetadata(metadata);
+            }
+            block.add(port);
+        }
+    }
+
+    bool atEnd() const
+    {
+        return _pos == _end;
+    }
+
+  private:
+    const char* readBytes(size_t count)
+    {
+        if ((size_t) (_end - _pos) < count)
+        {
+            throw Exception("Unexpected end of stored shader.");
+        }
+        const char* bytes = _pos;
+        _pos += count;
+        return bytes;
+    }
+
+  private:
+    const char* _pos;
+    const char* _end;
+    GenContext& _context;
+};
+
+} // anonymous namespace
+
+//
+// ShaderCacheStatistics methods
+//
+
+ShaderCacheStatistics::ShaderCacheStatistics() :
+    memoryHits(0),
+    diskHits(0),
+    misses(0),
+    invalidations(0)
+{
+}
+
+//
+// ShaderCache methods
+//
+
+ShaderCache::ShaderCache(const FilePath& storePath) :
+    _storePath(storePath),
+    _graphKeyLimit(MIN_GRAPH_KEY_LIMIT)
+{
+}
+
+ShaderPtr ShaderCache::generate(const string& name, ElementPtr element, GenContext& context)
+{
+    const string fullKey = computeFullKey(name, element, context);
+    const size_t key = std::hash<string>{}(fullKey);
+
+    // Return a valid shader from memory if one is available.  Dependencies
+    // are validated outside of the lock, since they require file reads.
+    Entry entry;
+    bool found = false;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _entries.find(key);
+        if (it != _entries.end() && it->second.fullKey == fullKey)
+        {
+            entry = it->second;
+            found = true;
+        }
+    }
+    if (found)
+    {
+        bool valid = isValid(entry);
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (valid)
+        {
+            _stats.memoryHits++;
+            return entry.shader;
+        }
+        _entries.erase(key);
+        _stats.invalidations++;
+    }
+
+    // Otherwise check the on-disk store.
+    if (!_storePath.isEmpty() && readEntry(key, fullKey, name, element, context, entry))
+    {
+        bool valid = isValid(entry);
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (valid)
+        {
+            _stats.diskHits++;
+            _entries[key] = entry;
+            return entry.shader;
+        }
+        _stats.invalidations++;
+    }
+
+    // Otherwise generate the shader, recording the content of the source
+    // files on which its stages depend.
+    entry.fullKey = fullKey;
+    entry.shader = context.getShaderGenerator().generate(name, element, context);
+    entry.dependencies.clear();
+    std::set<string> dependencies;
+    for (size_t i = 0; i < entry.shader->numStages(); i++)
+    {
+        const ShaderStage& stage = entry.shader->getStage(i);
+        dependencies.insert(stage.getIncludes().begin(), stage.getIncludes().end());
+        dependencies.insert(stage.getSourceDependencies().begin(), stage.getSourceDependencies().end());
+    }
+    for (const string& dependency : dependencies)
+    {
+        entry.dependencies.emplace_back(dependency, getFileHash(dependency));
+    }
+    if (!_storePath.isEmpty())
+    {
+        writeEntry(key, entry);
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.misses++;
+    _entries[key] = entry;
+    return entry.shader;
+}
+
+size_t ShaderCache::computeKey(const string& name, ConstElementPtr element, GenContext& context) const
+{
+    return std::hash<string>{}(computeFullKey(name, element, context));
+}
+
+string ShaderCache::computeFullKey(const string& name, ConstElementPtr element, GenContext& context) const
+{
+    const string& target = context.getShaderGenerator().getTarget();
+
+    string fullKey;
+    appendKey(fullKey, context.getConfigurationHash());
+    appendKey(fullKey, getVersionString());
+    appendKey(fullKey, name);
+    ShaderMetadataRegistryPtr registry = context.getUserData<ShaderMetadataRegistry>(ShaderMetadataRegistry::USER_DATA_NAME);
+    if (registry)
+    {
+        for (const ShaderMetadata& data : registry->getAllMetadata())
+        {
+            appendKey(fullKey, data.name);
+        }
+    }
+
+    // Append the document-level definitions that apply to all elements.
+    ConstDocumentPtr doc = element->getDocument();
+    for (ConstElementPtr def : doc->getTypeDefs())
+    {
+        appendKey(fullKey, def->getContentHash());
+    }
+    for (ConstElementPtr def : doc->getUnitTypeDefs())
+    {
+        appendKey(fullKey, def->getContentHash());
+    }
+    for (ConstElementPtr def : doc->getUnitDefs())
+    {
+        appendKey(fullKey, def->getContentHash());
+    }
+    for (ConstElementPtr def : doc->getGeomPropDefs())
+    {
+        appendKey(fullKey, def->getContentHash());
+    }
+
+    appendElementGraphKey(fullKey, element, target);
+    return fullKey;
+}
+
+void ShaderCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.clear();
+    _graphKeys.clear();
+    _graphKeyLimit = MIN_GRAPH_KEY_LIMIT;
+}
+
+ShaderCacheStatistics ShaderCache::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+bool ShaderCache::isValid(const Entry& entry)
+{
+    for (const auto& dependency : entry.dependencies)
+    {
+        if (getFileHash(dependency.first) != dependency.second)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t ShaderCache::getFileHash(const string& filename)
+{
+    // File contents are only read when their stamp has changed.
+    const size_t stamp = FilePath(filename).getModificationStamp();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _fileHashes.find(filename);
+        if (it != _fileHashes.end() && it->second.first == stamp)
+        {
+            return it->second.second;
+        }
+    }
+    const size_t hash = std::hash<string>{}(readFile(filename));
+    std::lock_guard<std::mutex> lock(_mutex);
+    _fileHashes[filename] = { stamp, hash };
+    return hash;
+}
+
+string ShaderCache::getDefinitionGraphKey(ConstNodeGraphPtr graph, const string& target) const
+{
+    // The key of a definition graph depends only on the graph itself and on
+    // the document in which its nodes are resolved, so it is memoized by the
+    // content hashes of the two.
+    size_t state = 0;
+    hashCombine(state, graph->getContentHash());
+    hashCombine(state, graph->getDocument()->getContentHash());
+    hashCombine(state, target);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _graphKeys.find(graph.get());
+        if (it != _graphKeys.end() && it->second.graph.lock() == graph && it->second.state == state)
+        {
+            return it->second.key;
+        }
+    }
+    string key;
+    appendElementGraphKey(key, graph, target);
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // Prune the keys of expired graphs whenever the number of memoized keys
+    // doubles, so that the cost of pruning is amortized.
+    if (_graphKeys.size() >= _graphKeyLimit)
+    {
+        for (auto it = _graphKeys.begin(); it != _graphKeys.end();)
+        {
+            it = it->second.graph.expired() ? _graphKeys.erase(it) : std::next(it);
+        }
+        _graphKeyLimit = std::max(MIN_GRAPH_KEY_LIMIT, _graphKeys.size() * 2);
+    }
+    _graphKeys[graph.get()] = { graph, state, key };
+    return key;
+}
+
+void ShaderCache::appendElementGraphKey(string& fullKey, ConstElementPtr root, const string& target) const
+{
+    std::unordered_set<ConstElementPtr> visited = { root };
+    vector<ConstElementPtr> pending = { root };
+    auto visit = [&visited, &pending](ConstElementPtr elem)
+    {
+        if (elem && visited.insert(elem).second)
+        {
+            pending.push_back(elem);
+        }
+    };
+
+    while (!pending.empty())
+    {
+        ConstElementPtr elem = pending.back();
+        pending.pop_back();
+
+        appendKey(fullKey, elem->getNamePath());
+        appendKey(fullKey, elem->getContentHash());
+        appendKey(fullKey, elem->getActiveColorSpace());
+        appendKey(fullKey, elem->getActiveFilePrefix());
+        appendKey(fullKey, elem->getActiveGeomPrefix());
+
+        // Graph interfaces are read through their parent graphs.
+        ConstElementPtr parent = elem->getParent();
+        if (parent && !parent->isA<Document>())
+        {
+            visit(parent);
+        }
+
+        if (elem->isA<NodeGraph>())
+        {
+            for (OutputPtr output : elem->asA<NodeGraph>()->getOutputs())
+            {
+                visit(output);
+            }
+        }
+        else if (elem->isA<Node>())
+        {
+            ConstNodePtr node = elem->asA<Node>();
+            NodeDefPtr nodeDef = node->getNodeDef(target);
+            if (nodeDef)
+            {
+                for (ConstElementPtr def : nodeDef->traverseInheritance())
+                {
+                    visit(def);
+                }
+                InterfaceElementPtr impl = nodeDef->getImplementation(target);
+                if (impl && impl->isA<NodeGraph>())
+                {
+                    appendKey(fullKey, getDefinitionGraphKey(impl->asA<NodeGraph>(), target));
+                }
+                else
+                {
+                    visit(impl);
+                }
+            }
+            for (InputPtr input : node->getInputs())
+            {
+                visit(input->getConnectedOutput());
+            }
+        }
+
+        for (size_t i = 0; i < elem->getUpstreamEdgeCount(); i++)
+        {
+            visit(elem->getUpstreamEdge(i).getUpstreamElement());
+        }
+    }
+}
+
+
+bool ShaderCache::readEntry(size_t key, const string& fullKey, const string& name, ConstElementPtr element, GenContext& context, Entry& entry) const
+{
+    const string buffer = readFile(getStoreFilename(_storePath, key));
+    if (buffer.empty())
+    {
+        return false;
+    }
+
+    // Stored shaders that are truncated, were written by a different
+    // version, or were stored under a different full key with the same hash
+    // are treated as absent.
+    try
+    {
+        StoreReader reader(buffer, context);
+        if (!reader.readHeader(key) || reader.readString() != fullKey)
+        {
+            return false;
+        }
+        entry.fullKey = fullKey;
+
+        entry.dependencies.clear();
+        size_t dependencyCount = (size_t) reader.readUint();
+        for (size_t i = 0; i < dependencyCount; i++)
+        {
+            const string filename = reader.readString();
+            entry.dependencies.emplace_back(filename, (size_t) reader.readUint(8));
+        }
+
+        ShaderGraphPtr graph = std::make_shared<ShaderGraph>(nullptr, name, element->getDocument(), StringSet());
+        graph->setClassification((uint32_t) reader.readUint());
+        ShaderPtr shader = std::make_shared<Shader>(name, graph);
+
+        size_t attributeCount = (size_t) reader.readUint();
+        for (size_t i = 0; i < attributeCount; i++)
+        {
+            const string attrName = reader.readString();
+            shader->setAttribute(attrName, reader.readValue());
+        }
+
+        size_t stageCount = (size_t) reader.readUint();
+        for (size_t i = 0; i < stageCount; i++)
+        {
+            ShaderStagePtr stage = context.getShaderGenerator().createStage(reader.readString(), *shader);
+            stage->setFunctionName(reader.readString());
+            stage->setSourceCode(reader.readString());
+            size_t includeCount = (size_t) reader.readUint();
+            for (size_t j = 0; j < includeCount; j++)
+            {
+                stage->_includes.insert(reader.readString());
+            }
+            size_t sourceDependencyCount = (size_t) reader.readUint();
+            for (size_t j = 0; j < sourceDependencyCount; j++)
+            {
+                stage->addSourceDependency(reader.readString());
+            }
+            reader.readBlock(stage->getConstantBlock());
+            for (auto createBlock : { &ShaderStage::createUniformBlock,
+                                      &ShaderStage::createInputBlock,
+                                      &ShaderStage::createOutputBlock })
+            {
+                size_t blockCount = (size_t) reader.readUint();
+                for (size_t j = 0; j < blockCount; j++)
+                {
+                    const string blockName = reader.readString();
+                    const string instance = reader.readString();
+                    VariableBlockPtr block = ((*stage).*createBlock)(blockName, instance);
+                    reader.readBlock(*block);
+                }
+            }
+        }
+        if (!reader.atEnd())
+        {
+            return false;
+        }
+        entry.shader = shader;
+    }
+    catch (Exception&)
+    {
+        return false;
+    }
+    return true;
+}
+
+void ShaderCache::writeEntry(size_t key, const Entry& entry) const
+{
+    StoreWriter writer;
+    writer.writeBytes(STORE_MAGIC, sizeof(STORE_MAGIC));
+    writer.writeUint(STORE_FORMAT_VERSION);
+    writer.writeUint(key, 8);
+    writer.writeString(entry.fullKey);
+
+    writer.writeUint(entry.dependencies.size());
+    for (const auto& dependency : entry.dependencies)
+    {
+        writer.writeString(dependency.first);
+        writer.writeUint(dependency.second, 8);
+    }
+
+    const Shader& shader = *entry.shader;
+    writer.writeUint(shader.getGraph().getClassification());
+    writer.writeUint(shader._attributeMap.size());
+    for (const auto& pair : shader._attributeMap)
+    {
+        writer.writeString(pair.first);
+        writer.writeValue(pair.second);
+    }
+
+    writer.writeUint(shader.numStages());
+    for (size_t i = 0; i < shader.numStages(); i++)
+    {
+        const ShaderStage& stage = shader.getStage(i);
+        writer.writeString(stage.getName());
+        writer.writeString(stage.getFunctionName());
+        writer.writeString(stage.getSourceCode());
+        for (const StringSet* files : { &stage.getIncludes(), &stage.getSourceDependencies() })
+        {
+            writer.writeUint(files->size());
+            for (const string& file : *files)
+            {
+                writer.writeString(file);
+            }
+        }
+        writer.writeBlock(stage.getConstantBlock());
+        writer.writeBlocks(stage.getUniformBlocks());
+        writer.writeBlocks(stage.getInputBlocks());
+        writer.writeBlocks(stage.getOutputBlocks());
+    }
+
+    // Write to a temporary file and rename it into place, so that concurrent
+    // readers never observe a partially written shader.
+    if (!_storePath.exists())
+    {
+        _storePath.createDirectory();
+    }
+    const FilePath filename = getStoreFilename(_storePath, key);
+    std::stringstream tempName;
+    tempName << filename.asString() << "." << std::hex << std::hash<std::thread::id>{}(std::this_thread::get_id()) << ".tmp";
+    {
+        std::ofstream ofs(tempName.str(), std::ios::out | std::ios::binary);
+        if (!ofs)
+        {
+            return;
+        }
+        const string& result = writer.getResult();
+        ofs.write(result.data(), (std::streamsize) result.size());
+    }
+    if (std::rename(tempName.str().c_str(), filename.asString().c_str()) != 0)
+    {
+        std::remove(filename.asString().c_str());
+        if (std::rename(tempName.str().c_str(), filename.asString().c_str()) != 0)
+        {
+            std::remove(tempName.str().c_str());
+        }
+    }
+}
+
+MATERIALX_NAMESPACE_END
@@ -0,0 +1,146 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef MATERIALX_SHADERCACHE_H
+#define MATERIALX_SHADERCACHE_H
+
+/// @file
+/// A content-addressed cache of generated shaders
+
+#include <MaterialXGenShader/Export.h>
+
+#include <MaterialXGenShader/Shader.h>
+
+#include <MaterialXFormat/File.h>
+
+#include <mutex>
+
+MATERIALX_NAMESPACE_BEGIN
+
+class GenContext;
+
+/// A shared pointer to a ShaderCache
+using ShaderCachePtr = shared_ptr<class ShaderCache>;
+
+/// @class ShaderCacheStatistics
+/// Statistics that are gathered by a ShaderCache.
+class MX_GENSHADER_API ShaderCacheStatistics
+{
+  public:
+    ShaderCacheStatistics();
+    ~ShaderCacheStatistics() = default;
+
+    /// The number of requests that were served from memory.
+    size_t memoryHits;
+
+    /// The number of requests that were served from the on-disk store.
+    size_t diskHits;
+
+    /// The number of requests that required shader generation.
+    size_t misses;
+
+    /// The number of cached shaders that were discarded because one of
+    /// their source file dependencies had changed.
+    size_t invalidations;
+};
+
+/// @class ShaderCache
+/// A content-addressed cache of generated shaders.
+///
+/// Each shader is keyed by the element graph upstream of the requested
+/// element, the node definitions and implementations that it references, and
+/// the configuration hash of the generation context, which covers the
+/// generator target, the color management and unit systems, the generation
+/// options and the source code search path (see
+/// GenContext::getConfigurationHash).  Shaders are looked up by a hash of
+/// their full key, and the full key is compared on each hit, so that hash
+/// collisions cannot return the wrong shader.  Each cached shader also
+/// records the content of the source files that its stages depend on, and a
+/// cached shader is regenerated if any of these files has since changed.
+///
+/// If a store path is given, then generated shaders are additionally written
+/// to that directory, allowing them to be shared between processes.  Shaders
+/// that are read from the store contain their generated stages and attributes,
+/// but their shader graph is an empty placeholder.
+///
+/// Shaders that are returned by the cache are shared between callers, and
+/// should not be modified.  User data in the generation context other than
+/// the shader metadata registry is not part of the cache key, so clients that
+/// rely on such data to vary generated code should use separate caches.
+class MX_GENSHADER_API ShaderCache
+{
+  public:
+    ShaderCache(const FilePath& storePath = FilePath());
+    ~ShaderCache() = default;
+
+    static ShaderCachePtr create(const FilePath& storePath = FilePath())
+    {
+        return std::make_shared<ShaderCache>(storePath);
+    }
+
+    /// Return the shader for the given element, generating it with the
+    /// shader generator of the given context if no valid cached shader
+    /// exists.  This method may be called from multiple threads, each
+    /// with its own generation context.
+    ShaderPtr generate(const string& name, ElementPtr element, GenContext& context);
+
+    /// Compute the cache key for the given shader name, element and context.
+    /// The returned key is a hash of the full key that is stored with each
+    /// cached shader.
+    size_t computeKey(const string& name, ConstElementPtr element, GenContext& context) const;
+
+    /// Clear all shaders and memoized definition graph keys from the
+    /// in-memory cache.  The on-disk store is not affected.
+    void clear();
+
+    /// Return the directory in which generated shaders are stored, or an
+    /// empty path if shaders are only cached in memory.
+    const FilePath& getStorePath() const
+    {
+        return _storePath;
+    }
+
+    /// Return the statistics that have been gathered by this cache.
+    ShaderCacheStatistics getStatistics() const;
+
+  private:
+    struct Entry
+    {
+        string fullKey;
+        ShaderPtr shader;
+        vector<std::pair<string, size_t>> dependencies;
+    };
+
+    // The memoized key of a definition graph.  Graphs are held by weak
+    // pointer, so that the cache does not keep graphs or their documents
+    // alive.
+    struct GraphKey
+    {
+        weak_ptr<const NodeGraph> graph;
+        size_t state;
+        string key;
+    };
+
+    string computeFullKey(const string& name, ConstElementPtr element, GenContext& context) const;
+    bool isValid(const Entry& entry);
+    size_t getFileHash(const string& filename);
+    string getDefinitionGraphKey(ConstNodeGraphPtr graph, const string& target) const;
+    void appendElementGraphKey(string& fullKey, ConstElementPtr root, const string& target) const;
+    bool readEntry(size_t key, const string& fullKey, const string& name, ConstElementPtr element, GenContext& context, Entry& entry) const;
+    void writeEntry(size_t key, const Entry& entry) const;
+
+  private:
+    FilePath _storePath;
+    std::unordered_map<size_t, Entry> _entries;
+    std::unordered_map<string, std::pair<size_t, size_t>> _fileHashes;
+    mutable std::unordered_map<const NodeGraph*, GraphKey> _graphKeys;
+    mutable size_t _graphKeyLimit;
+    ShaderCacheStatistics _stats;
+    mutable std::mutex _mutex;
+};
+
+MATERIALX_NAMESPACE_END
+
+#endif
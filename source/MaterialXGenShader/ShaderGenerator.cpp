@@ -296,7 +296,7 @@ ShaderNodeImplPtr ShaderGenerator::getImplementation(const NodeDef& nodedef, Gen
     const string& name = implElement->getName();
 
     // Check if it's created and cached already.
-    ShaderNodeImplPtr impl = context.findNodeImplementation(name);
+    ShaderNodeImplPtr impl = context.findNodeImplementation(*implElement);
     if (impl)
     {
         return impl;
@@ -330,7 +330,7 @@ ShaderNodeImplPtr ShaderGenerator::getImplementation(const NodeDef& nodedef, Gen
     impl->initialize(*implElement, context);
 
     // Cache it.
-    context.addNodeImplementation(name, impl);
+    context.addNodeImplementation(*implElement, impl);
 
     return impl;
 }
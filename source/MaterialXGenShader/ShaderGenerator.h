@@ -249,6 +249,7 @@ class MX_GENSHADER_API ShaderGenerator
     mutable StringMap _tokenSubstitutions;
 
     friend ShaderGraph;
+    friend class ShaderCache;
 };
 
 /// @class ExceptionShaderGenError
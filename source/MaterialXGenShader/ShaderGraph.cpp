@@ -8,12 +8,291 @@
 #include <MaterialXGenShader/GenContext.h>
 #include <MaterialXGenShader/ShaderGenerator.h>
 #include <MaterialXGenShader/Util.h>
+#include <MaterialXGenShader/Nodes/SourceCodeNode.h>
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
 #include <iostream>
 #include <queue>
 
 MATERIALX_NAMESPACE_BEGIN
 
+namespace
+{
+
+using FloatVec = vector<float>;
+using ConstantOperands = std::unordered_map<string, FloatVec>;
+
+template <class T> FloatVec getVectorComponents(const Value& value)
+{
+    const T& data = value.asA<T>();
+    return FloatVec(data.begin(), data.end());
+}
+
+// Return the components of a float-based value, or an empty vector for
+// values of any other type.
+FloatVec getValueComponents(const Value& value)
+{
+    if (value.isA<float>())
+    {
+        return FloatVec{ value.asA<float>() };
+    }
+    if (value.isA<Color3>())
+    {
+        return getVectorComponents<Color3>(value);
+    }
+    if (value.isA<Color4>())
+    {
+        return getVectorComponents<Color4>(value);
+    }
+    if (value.isA<Vector2>())
+    {
+        return getVectorComponents<Vector2>(value);
+    }
+    if (value.isA<Vector3>())
+    {
+        return getVectorComponents<Vector3>(value);
+    }
+    if (value.isA<Vector4>())
+    {
+        return getVectorComponents<Vector4>(value);
+    }
+    return FloatVec();
+}
+
+// Create a value of the given float-based type from its components.
+ValuePtr createValueFromComponents(TypeDesc type, const FloatVec& components)
+{
+    if (type == Type::FLOAT)
+    {
+        return Value::createValue(components[0]);
+    }
+    if (type == Type::COLOR3)
+    {
+        return Value::createValue(Color3(components));
+    }
+    if (type == Type::COLOR4)
+    {
+        return Value::createValue(Color4(components));
+    }
+    if (type == Type::VECTOR2)
+    {
+        return Value::createValue(Vector2(components));
+    }
+    if (type == Type::VECTOR3)
+    {
+        return Value::createValue(Vector3(components));
+    }
+    if (type == Type::VECTOR4)
+    {
+        return Value::createValue(Vector4(components));
+    }
+    return nullptr;
+}
+
+size_t getComponentCount(TypeDesc type)
+{
+    if (type == Type::FLOAT)
+    {
+        return 1;
+    }
+    if (type == Type::VECTOR2)
+    {
+        return 2;
+    }
+    if (type == Type::COLOR3 || type == Type::VECTOR3)
+    {
+        return 3;
+    }
+    if (type == Type::COLOR4 || type == Type::VECTOR4)
+    {
+        return 4;
+    }
+    return 0;
+}
+
+using ComponentOp = std::function<float(const FloatVec&)>;
+
+// Component-wise operations of standard library math nodes, each taking
+// one component of the named inputs in order.
+const std::unordered_map<string, std::pair<StringVec, ComponentOp>> COMPONENT_OPS =
+{
+    { "add", { { "in1", "in2" }, [](const FloatVec& v) { return v[0] + v[1]; } } },
+    { "subtract", { { "in1", "in2" }, [](const FloatVec& v) { return v[0] - v[1]; } } },
+    { "multiply", { { "in1", "in2" }, [](const FloatVec& v) { return v[0] * v[1]; } } },
+    { "divide", { { "in1", "in2" }, [](const FloatVec& v) { return v[0] / v[1]; } } },
+    { "modulo", { { "in1", "in2" }, [](const FloatVec& v) { return v[0] - v[1] * std::floor(v[0] / v[1]); } } },
+    { "power", { { "in1", "in2" }, [](const FloatVec& v) { return std::pow(v[0], v[1]); } } },
+    { "min", { { "in1", "in2" }, [](const FloatVec& v) { return std::min(v[0], v[1]); } } },
+    { "max", { { "in1", "in2" }, [](const FloatVec& v) { return std::max(v[0], v[1]); } } },
+    { "invert", { { "in", "amount" }, [](const FloatVec& v) { return v[1] - v[0]; } } },
+    { "absval", { { "in" }, [](const FloatVec& v) { return std::abs(v[0]); } } },
+    { "sign", { { "in" }, [](const FloatVec& v) { return (float) ((v[0] > 0.0f) - (v[0] < 0.0f)); } } },
+    { "floor", { { "in" }, [](const FloatVec& v) { return std::floor(v[0]); } } },
+    { "ceil", { { "in" }, [](const FloatVec& v) { return std::ceil(v[0]); } } },
+    { "fract", { { "in" }, [](const FloatVec& v) { return v[0] - std::floor(v[0]); } } },
+    { "sqrt", { { "in" }, [](const FloatVec& v) { return std::sqrt(v[0]); } } },
+    { "exp", { { "in" }, [](const FloatVec& v) { return std::exp(v[0]); } } },
+    { "ln", { { "in" }, [](const FloatVec& v) { return std::log(v[0]); } } },
+    { "sin", { { "in" }, [](const FloatVec& v) { return std::sin(v[0]); } } },
+    { "cos", { { "in" }, [](const FloatVec& v) { return std::cos(v[0]); } } },
+    { "tan", { { "in" }, [](const FloatVec& v) { return std::tan(v[0]); } } },
+    { "clamp", { { "in", "low", "high" }, [](const FloatVec& v) { return std::min(std::max(v[0], v[1]), v[2]); } } },
+    { "mix", { { "fg", "bg", "mix" }, [](const FloatVec& v) { return v[1] * (1.0f - v[2]) + v[0] * v[2]; } } }
+};
+
+// Evaluate a standard library math node for the given constant operands,
+// returning nullptr if the node is not supported or its result is not
+// finite.
+ValuePtr evaluateMathNode(const string& category, const ConstantOperands& operands, TypeDesc outputType)
+{
+    const size_t outputCount = getComponentCount(outputType);
+    if (!outputCount)
+    {
+        return nullptr;
+    }
+
+    FloatVec result;
+    auto opIt = COMPONENT_OPS.find(category);
+    if (opIt != COMPONENT_OPS.end())
+    {
+        // Each operand is either a scalar or matches the output in size.
+        const StringVec& names = opIt->second.first;
+        vector<const FloatVec*> args;
+        for (const string& name : names)
+        {
+            auto it = operands.find(name);
+            if (it == operands.end() || (it->second.size() != 1 && it->second.size() != outputCount))
+            {
+                return nullptr;
+            }
+            args.push_back(&it->second);
+        }
+        if (operands.size() != names.size())
+        {
+            return nullptr;
+        }
+        FloatVec components(args.size());
+        for (size_t i = 0; i < outputCount; i++)
+        {
+            for (size_t j = 0; j < args.size(); j++)
+            {
+                components[j] = args[j]->size() == 1 ? (*args[j])[0] : (*args[j])[i];
+            }
+            result.push_back(opIt->second.second(components));
+        }
+    }
+    else if (category == "dotproduct" || category == "magnitude" || category == "normalize")
+    {
+        const bool isDot = category == "dotproduct";
+        auto in1 = operands.find(isDot ? "in1" : "in");
+        auto in2 = operands.find(isDot ? "in2" : "in");
+        if (in1 == operands.end() || in2 == operands.end() || operands.size() != (isDot ? 2 : 1) ||
+            in1->second.size() != in2->second.size())
+        {
+            return nullptr;
+        }
+        float dot = 0.0f;
+        for (size_t i = 0; i < in1->second.size(); i++)
+        {
+            dot += in1->second[i] * in2->second[i];
+        }
+        if (category == "dotproduct")
+        {
+            result.push_back(dot);
+        }
+        else if (category == "magnitude")
+        {
+            result.push_back(std::sqrt(dot));
+        }
+        else
+        {
+            for (float component : in1->second)
+            {
+                result.push_back(component / std::sqrt(dot));
+            }
+        }
+    }
+    if (result.size() != outputCount ||
+        !std::all_of(result.begin(), result.end(), [](float component) { return std::isfinite(component); }))
+    {
+        return nullptr;
+    }
+    return createValueFromComponents(outputType, result);
+}
+
+// Return a map from the names of the given standard library nodedefs,
+// listed as node strings with their nodedef type suffixes, to their node
+// strings.
+std::unordered_map<string, string> createNodeDefMap(const vector<std::pair<string, StringVec>>& nodeDefs)
+{
+    std::unordered_map<string, string> nodeDefMap;
+    for (const auto& pair : nodeDefs)
+    {
+        for (const string& suffix : pair.second)
+        {
+            nodeDefMap["ND_" + pair.first + "_" + suffix] = pair.first;
+        }
+    }
+    return nodeDefMap;
+}
+
+const StringVec BINARY_TYPES = { "float", "color3", "color4", "vector2", "vector3", "vector4",
+                                 "color3FA", "color4FA", "vector2FA", "vector3FA", "vector4FA" };
+const StringVec UNARY_TYPES = { "float", "color3", "color4", "vector2", "vector3", "vector4" };
+const StringVec FLOAT_VECTOR_TYPES = { "float", "vector2", "vector3", "vector4" };
+const StringVec VECTOR_TYPES = { "vector2", "vector3", "vector4" };
+
+// The standard library nodedefs whose nodes may be folded or merged.  Nodes
+// are identified by nodedef name rather than by node string, since custom
+// nodedefs may reuse the node strings of the standard library.
+const std::unordered_map<string, string> STANDARD_NODEDEFS = createNodeDefMap(
+{
+    { "add", BINARY_TYPES },
+    { "subtract", BINARY_TYPES },
+    { "multiply", BINARY_TYPES },
+    { "divide", BINARY_TYPES },
+    { "modulo", BINARY_TYPES },
+    { "power", BINARY_TYPES },
+    { "min", BINARY_TYPES },
+    { "max", BINARY_TYPES },
+    { "invert", BINARY_TYPES },
+    { "clamp", BINARY_TYPES },
+    { "absval", UNARY_TYPES },
+    { "sign", UNARY_TYPES },
+    { "floor", UNARY_TYPES },
+    { "ceil", UNARY_TYPES },
+    { "fract", UNARY_TYPES },
+    { "sqrt", FLOAT_VECTOR_TYPES },
+    { "exp", FLOAT_VECTOR_TYPES },
+    { "ln", FLOAT_VECTOR_TYPES },
+    { "sin", FLOAT_VECTOR_TYPES },
+    { "cos", FLOAT_VECTOR_TYPES },
+    { "tan", FLOAT_VECTOR_TYPES },
+    { "mix", { "float", "color3", "color3_color3", "color4", "color4_color4", "vector2", "vector2_vector2",
+               "vector3", "vector3_vector3", "vector4", "vector4_vector4" } },
+    { "dotproduct", VECTOR_TYPES },
+    { "magnitude", VECTOR_TYPES },
+    { "normalize", VECTOR_TYPES },
+    { "image", UNARY_TYPES }
+});
+
+// Return the node string of a node created from one of the standard library
+// nodedefs above and implemented in source code, or an empty string for any
+// other node.
+const string& getStandardNodeString(const ShaderNode& node)
+{
+    auto it = STANDARD_NODEDEFS.find(node.getNodeDefName());
+    if (it == STANDARD_NODEDEFS.end() || !dynamic_cast<const SourceCodeNode*>(&node.getImplementation()))
+    {
+        return EMPTY_STRING;
+    }
+    return it->second;
+}
+
+} // anonymous namespace
+
 //
 // ShaderGraph methods
 //
@@ -836,7 +1115,7 @@ void ShaderGraph::finalize(GenContext& context)
     _outputUnitTransformMap.clear();
 
     // Optimize the graph, removing redundant paths.
-    optimize();
+    optimize(context);
 
     // Sort the nodes in topological order.
     topologicalSort();
@@ -896,7 +1175,7 @@ void ShaderGraph::disconnect(ShaderNode* node) const
     }
 }
 
-void ShaderGraph::optimize()
+void ShaderGraph::optimize(GenContext& context)
 {
     size_t numEdits = 0;
     for (ShaderNode* node : getNodes())
@@ -921,6 +1200,15 @@ void ShaderGraph::optimize()
         // "uniform" in the NodeDef or to handle very specific cases, like FILENAME.
     }
 
+    if (context.getOptions().optimizeShaderGraph)
+    {
+        // Both passes visit nodes in topological order, so that folded
+        // and merged nodes expose further candidates downstream.
+        topologicalSort();
+        numEdits += foldConstantNodes();
+        numEdits += mergeIdenticalNodes();
+    }
+
     if (numEdits > 0)
     {
         std::set<ShaderNode*> usedNodesSet;
@@ -962,6 +1250,122 @@ void ShaderGraph::optimize()
     }
 }
 
+size_t ShaderGraph::foldConstantNodes()
+{
+    size_t numFolded = 0;
+    for (ShaderNode* node : getNodes())
+    {
+        const string& nodeString = getStandardNodeString(*node);
+        if (node->numOutputs() != 1 || nodeString.empty())
+        {
+            continue;
+        }
+
+        // Results are only moved to the inputs of other nodes, leaving
+        // graph outputs connected.
+        ShaderOutput* output = node->getOutput();
+        const ShaderInputVec& downstreamConnections = output->getConnections();
+        if (downstreamConnections.empty() ||
+            std::any_of(downstreamConnections.begin(), downstreamConnections.end(),
+                        [this](const ShaderInput* downstream) { return downstream->getNode() == this; }))
+        {
+            continue;
+        }
+
+        ConstantOperands operands;
+        bool isConstant = true;
+        for (const ShaderInput* input : node->getInputs())
+        {
+            FloatVec components = input->getConnection() || !input->getValue() ?
+                                  FloatVec() :
+                                  getValueComponents(*input->getValue());
+            if (components.empty())
+            {
+                isConstant = false;
+                break;
+            }
+            operands[input->getName()] = std::move(components);
+        }
+        if (!isConstant)
+        {
+            continue;
+        }
+
+        ValuePtr result = evaluateMathNode(nodeString, operands, output->getType());
+        if (!result)
+        {
+            continue;
+        }
+
+        // Iterate a copy of the connection vector since the
+        // original vector will change when breaking connections.
+        ShaderInputVec connections = downstreamConnections;
+        for (ShaderInput* downstream : connections)
+        {
+            output->breakConnection(downstream);
+            downstream->setValue(result);
+        }
+        ++numFolded;
+    }
+    return numFolded;
+}
+
+size_t ShaderGraph::mergeIdenticalNodes()
+{
+    size_t numMerged = 0;
+    std::unordered_map<string, ShaderNode*> mergedNodes;
+    for (ShaderNode* node : getNodes())
+    {
+        if (!node->numOutputs() || getStandardNodeString(*node).empty())
+        {
+            continue;
+        }
+
+        // Build a key from the implementation, the output types and the
+        // upstream connection or value of each input.  Implementations are
+        // shared between the nodes of a context, and are compared by address
+        // since those created without an element have no name or hash.
+        string key = std::to_string(reinterpret_cast<uintptr_t>(&node->getImplementation()));
+        for (const ShaderOutput* output : node->getOutputs())
+        {
+            key += '|' + output->getName() + ':' + output->getType().getName();
+        }
+        for (const ShaderInput* input : node->getInputs())
+        {
+            key += '|' + input->getName() + ':' + input->getType().getName();
+            if (input->getConnection())
+            {
+                key += '@' + std::to_string(reinterpret_cast<uintptr_t>(input->getConnection()));
+            }
+            else
+            {
+                key += '=' + input->getValueString() + ':' + input->getUnit() + ':' + input->getColorSpace();
+            }
+        }
+
+        auto it = mergedNodes.emplace(key, node);
+        if (it.second)
+        {
+            continue;
+        }
+
+        ShaderNode* mergedNode = it.first->second;
+        for (size_t i = 0; i < node->numOutputs(); ++i)
+        {
+            ShaderOutput* output = node->getOutput(i);
+            ShaderOutput* mergedOutput = mergedNode->getOutput(i);
+            ShaderInputVec downstreamConnections = output->getConnections();
+            for (ShaderInput* downstream : downstreamConnections)
+            {
+                output->breakConnection(downstream);
+                downstream->makeConnection(mergedOutput);
+            }
+        }
+        ++numMerged;
+    }
+    return numMerged;
+}
+
 void ShaderGraph::bypass(ShaderNode* node, size_t inputIndex, size_t outputIndex)
 {
     ShaderInput* input = node->getInput(inputIndex);
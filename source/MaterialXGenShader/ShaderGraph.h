@@ -159,7 +159,17 @@ class MX_GENSHADER_API ShaderGraph : public ShaderNode
     void finalize(GenContext& context);
 
     /// Optimize the graph, removing redundant paths.
-    void optimize();
+    void optimize(GenContext& context);
+
+    /// Evaluate standard library math nodes whose inputs are all constant,
+    /// moving their results downstream.  Returns the number of folded nodes.
+    size_t foldConstantNodes();
+
+    /// Merge standard library math and image nodes that share an
+    /// implementation and have identical inputs, reconnecting the downstream
+    /// ports of each duplicate to the first such node.  Returns the number of
+    /// merged nodes.
+    size_t mergeIdenticalNodes();
 
     /// Bypass a node for a particular input and output,
     /// effectively connecting the input's upstream connection
@@ -424,6 +424,13 @@ class MX_GENSHADER_API ShaderNode
         return _name;
     }
 
+    /// Return the name of the nodedef this node was created from, or an
+    /// empty string if the node was created from an implementation.
+    const string& getNodeDefName() const
+    {
+        return _nodeDefName;
+    }
+
     /// Return the implementation used for this node.
     const ShaderNodeImpl& getImplementation() const
     {
@@ -489,6 +496,7 @@ class MX_GENSHADER_API ShaderNode
 
     const ShaderGraph* _parent;
     string _name;
+    string _nodeDefName;
     uint32_t _classification;
 
     std::unordered_map<string, ShaderInputPtr> _inputMap;
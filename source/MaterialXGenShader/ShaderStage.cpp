@@ -7,6 +7,7 @@
 
 #include <MaterialXGenShader/ShaderGenerator.h>
 #include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/SourceFile.h>
 #include <MaterialXGenShader/Syntax.h>
 #include <MaterialXGenShader/Util.h>
 
@@ -312,33 +313,7 @@ void ShaderStage::addComment(const string& str)
 
 void ShaderStage::addBlock(const string& str, const FilePath& sourceFilename, GenContext& context)
 {
-    const string& INCLUDE = _syntax->getIncludeStatement();
-    const string& QUOTE   = _syntax->getStringQuote();
-
-    // Add each line in the block separately to get correct indentation.
-    StringStream stream(str);
-    for (string line; std::getline(stream, line);)
-    {
-        size_t pos = line.find(INCLUDE);
-        if (pos != string::npos)
-        {
-            size_t startQuote = line.find_first_of(QUOTE);
-            size_t endQuote = line.find_last_of(QUOTE);
-            if (startQuote != string::npos && endQuote != string::npos && endQuote > startQuote)
-            {
-                size_t length = (endQuote - startQuote) - 1;
-                if (length)
-                {
-                    const string filename = line.substr(startQuote + 1, length);
-                    addInclude(filename, sourceFilename, context);
-                }
-            }
-        }
-        else
-        {
-            addLine(line, false);
-        }
-    }
+    addSourceFile(SourceFile(str, *_syntax), sourceFilename, context);
 }
 
 void ShaderStage::addInclude(const FilePath& includeFilename, const FilePath& sourceFilename, GenContext& context)
@@ -349,13 +324,37 @@ void ShaderStage::addInclude(const FilePath& includeFilename, const FilePath& so
 
     if (!_includes.count(resolvedFile))
     {
-        string content = readFile(resolvedFile);
-        if (content.empty())
+        ConstSourceFilePtr file = getSourceFile(resolvedFile, *_syntax, context.getFileSearchCache().get());
+        if (!file)
         {
             throw ExceptionShaderGenError("Could not find include file: '" + includeFilename.asString() + "'");
         }
         _includes.insert(resolvedFile);
-        addBlock(content, resolvedFile, context);
+        addSourceFile(*file, resolvedFile, context);
+    }
+}
+
+void ShaderStage::addSourceFile(const SourceFile& file, const FilePath& sourceFilename, GenContext& context)
+{
+    for (const SourceFile::Segment& segment : file.getSegments())
+    {
+        // Add each line separately when indented, and otherwise append
+        // the pre-joined lines in bulk.
+        if (_indentations)
+        {
+            for (const string& line : segment.lines)
+            {
+                addLine(line, false);
+            }
+        }
+        else
+        {
+            _code += segment.text;
+        }
+        if (!segment.include.empty())
+        {
+            addInclude(segment.include, sourceFilename, context);
+        }
     }
 }
 
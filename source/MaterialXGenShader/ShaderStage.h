@@ -35,6 +35,8 @@
 
 MATERIALX_NAMESPACE_BEGIN
 
+class SourceFile;
+
 namespace Stage
 {
 
@@ -258,6 +260,10 @@ class MX_GENSHADER_API ShaderStage
     /// Add the contents of an include file if not already present.
     void addInclude(const FilePath& includeFilename, const FilePath& sourceFilename, GenContext& context);
 
+    /// Add the segments of a parsed source file, resolving its include
+    /// directives relative to the given source filename.
+    void addSourceFile(const SourceFile& file, const FilePath& sourceFilename, GenContext& context);
+
     /// Return true if this stage depends on the given source file.
     bool hasSourceDependency(const FilePath& file);
 
@@ -332,6 +338,7 @@ class MX_GENSHADER_API ShaderStage
     string _code;
 
     friend class ShaderGenerator;
+    friend class ShaderCache;
 };
 
 /// Shared pointer to a ShaderStage
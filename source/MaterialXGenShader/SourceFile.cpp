@@ -0,0 +1,138 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <MaterialXGenShader/SourceFile.h>
+
+#include <MaterialXGenShader/Syntax.h>
+
+#include <MaterialXFormat/Util.h>
+
+#include <shared_mutex>
+#include <sstream>
+
+MATERIALX_NAMESPACE_BEGIN
+
+namespace
+{
+
+class SourceFileCache
+{
+  public:
+    ConstSourceFilePtr get(const FilePath& filename, const Syntax& syntax, FileSearchCache* searchCache)
+    {
+        const FilePath normalized = filename.getNormalized();
+        const size_t stamp = searchCache ? searchCache->getModificationStamp(normalized) : normalized.getModificationStamp();
+        if (!stamp)
+        {
+            return nullptr;
+        }
+
+        // Parsed files depend on the include and newline conventions of the syntax.
+        string key = normalized.asString();
+        for (const string* str : { &syntax.getIncludeStatement(), &syntax.getStringQuote(), &syntax.getNewline() })
+        {
+            key += '\0';
+            key += *str;
+        }
+
+        {
+            std::shared_lock<std::shared_mutex> lock(_mutex);
+            auto it = _files.find(key);
+            if (it != _files.end() && it->second.first == stamp)
+            {
+                return it->second.second;
+            }
+        }
+
+        const string content = readFile(normalized);
+        if (content.empty())
+        {
+            return nullptr;
+        }
+        ConstSourceFilePtr file = std::make_shared<SourceFile>(content, syntax);
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        _files[key] = { stamp, file };
+        return file;
+    }
+
+    void clear()
+    {
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        _files.clear();
+    }
+
+  private:
+    std::unordered_map<string, std::pair<size_t, ConstSourceFilePtr>> _files;
+    std::shared_mutex _mutex;
+};
+
+SourceFileCache& getSourceFileCache()
+{
+    static SourceFileCache cache;
+    return cache;
+}
+
+} // anonymous namespace
+
+//
+// SourceFile methods
+//
+
+SourceFile::SourceFile(const string& content, const Syntax& syntax) :
+    _content(content)
+{
+    const string& INCLUDE = syntax.getIncludeStatement();
+    const string& QUOTE = syntax.getStringQuote();
+    const string& NEWLINE = syntax.getNewline();
+
+    _segments.emplace_back();
+    std::istringstream stream(_content);
+    for (string line; std::getline(stream, line);)
+    {
+        size_t pos = line.find(INCLUDE);
+        if (pos != string::npos)
+        {
+            // Include directives without a valid filename are omitted.
+            size_t startQuote = line.find_first_of(QUOTE);
+            size_t endQuote = line.find_last_of(QUOTE);
+            if (startQuote != string::npos && endQuote != string::npos && endQuote > startQuote)
+            {
+                size_t length = (endQuote - startQuote) - 1;
+                if (length)
+                {
+                    _segments.back().include = line.substr(startQuote + 1, length);
+                    _segments.emplace_back();
+                }
+            }
+        }
+        else
+        {
+            Segment& segment = _segments.back();
+            segment.text += line;
+            segment.text += NEWLINE;
+            segment.lines.push_back(std::move(line));
+        }
+    }
+    if (_segments.back().lines.empty())
+    {
+        _segments.pop_back();
+    }
+}
+
+//
+// Global functions
+//
+
+ConstSourceFilePtr getSourceFile(const FilePath& filename, const Syntax& syntax, FileSearchCache* searchCache)
+{
+    return getSourceFileCache().get(filename, syntax, searchCache);
+}
+
+void clearSourceFileCache()
+{
+    getSourceFileCache().clear();
+}
+
+MATERIALX_NAMESPACE_END
@@ -0,0 +1,82 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef MATERIALX_SOURCEFILE_H
+#define MATERIALX_SOURCEFILE_H
+
+/// @file
+/// Parsed shader source files and their process-wide cache
+
+#include <MaterialXGenShader/Export.h>
+
+#include <MaterialXFormat/File.h>
+#include <MaterialXFormat/FileCache.h>
+
+MATERIALX_NAMESPACE_BEGIN
+
+class Syntax;
+
+/// A shared pointer to a const SourceFile
+using ConstSourceFilePtr = shared_ptr<const class SourceFile>;
+
+/// @class SourceFile
+/// The content of a shader source file, split into lines, with the include
+/// directives of a given syntax parsed out.
+class MX_GENSHADER_API SourceFile
+{
+  public:
+    /// A run of consecutive source lines, followed by an optional include
+    /// directive.
+    struct Segment
+    {
+        /// The lines of the run, without line endings.
+        StringVec lines;
+
+        /// The lines of the run, each followed by the syntax newline.
+        string text;
+
+        /// The filename of the include directive following the run, or an
+        /// empty string if the run ends the file.
+        string include;
+    };
+
+    /// Split the given source code into segments, recognizing the include
+    /// directives of the given syntax.
+    SourceFile(const string& content, const Syntax& syntax);
+    ~SourceFile() = default;
+
+    /// Return the unmodified content of the source file.
+    const string& getContent() const
+    {
+        return _content;
+    }
+
+    /// Return the segments of the source file.
+    const vector<Segment>& getSegments() const
+    {
+        return _segments;
+    }
+
+  private:
+    string _content;
+    vector<Segment> _segments;
+};
+
+/// Return the parsed content of the given shader source file for the given
+/// syntax, or nullptr if the file cannot be read.  Files are cached for the
+/// lifetime of the process, keyed by their normalized path, and are re-read
+/// when their modification stamp changes.  If a file search cache is given,
+/// then modification stamps are queried through it, and files are only
+/// re-read once the cache has been invalidated.  This function may be called
+/// from multiple threads.
+MX_GENSHADER_API ConstSourceFilePtr getSourceFile(const FilePath& filename, const Syntax& syntax,
+                                                  FileSearchCache* searchCache = nullptr);
+
+/// Clear the process-wide cache of shader source files.
+MX_GENSHADER_API void clearSourceFileCache();
+
+MATERIALX_NAMESPACE_END
+
+#endif
@@ -31,7 +31,7 @@ bool isEqual(float v1, float v2)
     return std::abs(v1 - v2) < EPSILON;
 }
 
-bool isEqual(ValuePtr value, float f)
+bool isEqual(ConstValuePtr value, float f)
 {
     if (value->isA<float>() && isEqual(value->asA<float>(), f))
     {
@@ -82,7 +82,7 @@ bool hasTransparentInputs(const OpaqueTestPairList& opaqueInputList, NodePtr nod
             {
                 return true;
             }
-            ValuePtr value = interfaceInput->getValue();
+            ConstValuePtr value = interfaceInput->getConstValue();
             if (value && !isEqual(value, opaqueInput.second))
             {
                 return true;
@@ -194,7 +194,7 @@ bool isTransparentShaderNode(NodePtr node, NodePtr interfaceNode)
             }
             else
             {
-                ValuePtr value = checkInput->getValue();
+                ConstValuePtr value = checkInput->getConstValue();
                 if (value && !isEqual(value, inputPair.second))
                 {
                     return true;
@@ -49,6 +49,16 @@ TEST_CASE("String utilities", "[coreutil]")
     REQUIRE(!mx::stringStartsWith("testName", "Name"));
     REQUIRE(mx::stringEndsWith("testName", "Name"));
     REQUIRE(!mx::stringEndsWith("testName", "test"));
+
+    const std::string& interned = mx::internString("testName");
+    REQUIRE(interned == "testName");
+    REQUIRE(&mx::internString(std::string("test") + "Name") == &interned);
+    REQUIRE(&mx::internString("testName2") != &interned);
+    static const std::string staticName = "testStaticName";
+    REQUIRE(&mx::internStaticString(staticName) == &staticName);
+    REQUIRE(&mx::internString("testStaticName") == &staticName);
+    REQUIRE(&mx::internStaticString(interned) == &interned);
+    REQUIRE(&mx::internString(mx::TypedElement::TYPE_ATTRIBUTE) == &mx::TypedElement::TYPE_ATTRIBUTE);
 }
 
 TEST_CASE("Print utilities", "[coreutil]")
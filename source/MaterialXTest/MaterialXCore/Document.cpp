@@ -10,6 +10,8 @@
 #include <MaterialXFormat/Util.h>
 #include <MaterialXFormat/XmlIo.h>
 
+#include <thread>
+
 namespace mx = MaterialX;
 
 TEST_CASE("Document", "[document]")
@@ -121,6 +123,414 @@ TEST_CASE("Document", "[document]")
     REQUIRE(doc->validate());
 }
 
+TEST_CASE("Document cache", "[document]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, mx::getDefaultDataSearchPath(), doc);
+
+    // Return the names of all cached lookup results for the given keys.
+    auto getLookupNames = [doc](const mx::StringVec& keys)
+    {
+        mx::StringVec names;
+        for (const std::string& key : keys)
+        {
+            for (mx::NodeDefPtr nodeDef : doc->getMatchingNodeDefs(key))
+                names.push_back(nodeDef->getNamePath());
+            for (mx::InterfaceElementPtr impl : doc->getMatchingImplementations(key))
+                names.push_back(impl->getNamePath());
+            for (mx::PortElementPtr port : doc->getMatchingPorts(key))
+                names.push_back(port->getNamePath());
+            names.push_back("|");
+        }
+        return names;
+    };
+
+    // Verify that incremental cache updates match a full rebuild.
+    auto verifyCache = [doc, getLookupNames](const mx::StringVec& keys)
+    {
+        mx::StringVec incremental = getLookupNames(keys);
+        doc->invalidateCache();
+        REQUIRE(getLookupNames(keys) == incremental);
+    };
+
+    const mx::StringVec keys = { "add", "ND_add_float", "ND_image_color3", "customAdd", "ND_customAdd",
+                                 "NG_customAdd", "node1", "graph1", "custom:customAdd" };
+    verifyCache(keys);
+
+    // Add and modify elements.
+    mx::NodeDefPtr nodeDef = doc->addNodeDef("ND_customAdd", "float", "customAdd");
+    nodeDef->setNodeString("add");
+    mx::NodeGraphPtr implGraph = doc->addNodeGraph("NG_customAdd");
+    implGraph->setNodeDef(nodeDef);
+    mx::ImplementationPtr impl = doc->addImplementation("IM_customAdd");
+    impl->setNodeDef(doc->getNodeDef("ND_add_float"));
+    impl->setAttribute(mx::Implementation::NODE_GRAPH_ATTRIBUTE, "NG_customAdd");
+    verifyCache(keys);
+
+    // Add a nodegraph with downstream ports, then edit its connections.
+    mx::NodeGraphPtr graph = doc->addNodeGraph("graph1");
+    mx::NodePtr node = graph->addNode("add", "node1", "float");
+    mx::OutputPtr output = graph->addOutput("out", "float");
+    output->setNodeName("node1");
+    mx::NodePtr downstream = doc->addNode("add", "downstream", "float");
+    downstream->addInput("in1", "float")->setNodeGraphString("graph1");
+    verifyCache(keys);
+    doc->setChildIndex(downstream->getName(), 0);
+    verifyCache(keys);
+    output->removeAttribute(mx::PortElement::NODE_NAME_ATTRIBUTE);
+    verifyCache(keys);
+
+    // Unrelated attribute changes and renames.
+    nodeDef->setDocString("Custom addition");
+    node->setName("node2");
+    implGraph->setName("NG_customAdd2");
+    verifyCache(keys);
+    implGraph->setName("NG_customAdd");
+    verifyCache(keys);
+
+    // Namespace changes.
+    nodeDef->setNamespace("custom");
+    verifyCache(keys);
+
+    // Remove elements.
+    doc->removeNodeGraph("NG_customAdd");
+    verifyCache(keys);
+    doc->removeNodeGraph("graph1");
+    doc->removeNodeDef("ND_customAdd");
+    doc->removeImplementation("IM_customAdd");
+    verifyCache(keys);
+}
+
+TEST_CASE("Concurrent document lookups", "[document]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, mx::getDefaultDataSearchPath(), doc);
+    std::vector<mx::NodeDefPtr> nodeDefs = doc->getNodeDefs();
+    REQUIRE(!nodeDefs.empty());
+
+    // Perform nodedef and implementation lookups for every nodedef in the
+    // document, returning the total number of matches.
+    auto lookupNodeDefs = [doc, &nodeDefs]()
+    {
+        size_t matchCount = 0;
+        for (mx::NodeDefPtr nodeDef : nodeDefs)
+        {
+            matchCount += doc->getMatchingNodeDefs(nodeDef->getNodeString()).size();
+            matchCount += doc->getMatchingImplementations(nodeDef->getName()).size();
+        }
+        return matchCount;
+    };
+
+    // Perform lookups across the given number of threads, returning the
+    // match counts of each thread.
+    auto lookupConcurrently = [lookupNodeDefs](size_t threadCount)
+    {
+        std::vector<size_t> matchCounts(threadCount);
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < threadCount; i++)
+        {
+            threads.emplace_back([&matchCounts, lookupNodeDefs, i]()
+            {
+                matchCounts[i] = lookupNodeDefs();
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        return matchCounts;
+    };
+
+    // Verify that concurrent readers of an invalid cache observe the same
+    // results as a serial reader.
+    size_t serialCount = lookupNodeDefs();
+    REQUIRE(serialCount > 0);
+    doc->invalidateCache();
+    for (size_t matchCount : lookupConcurrently(8))
+    {
+        REQUIRE(matchCount == serialCount);
+    }
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+    for (size_t threadCount : { 1, 2, 4, 8 })
+    {
+        BENCHMARK("Nodedef lookups with " + std::to_string(threadCount) + " threads")
+        {
+            return lookupConcurrently(threadCount);
+        };
+    }
+#endif
+}
+
+TEST_CASE("Value caching", "[document]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, mx::getDefaultDataSearchPath(), doc);
+    std::vector<mx::InputPtr> inputs;
+    for (mx::NodeDefPtr nodeDef : doc->getNodeDefs())
+    {
+        for (mx::InputPtr input : nodeDef->getInputs())
+        {
+            if (input->hasValue())
+            {
+                inputs.push_back(input);
+            }
+        }
+    }
+    REQUIRE(!inputs.empty());
+
+    // Verify that cached values match freshly parsed values.
+    REQUIRE(doc->getValueCaching());
+    for (mx::InputPtr input : inputs)
+    {
+        mx::ValuePtr value = input->getValue();
+        mx::ValuePtr parsed = mx::Value::createValueFromStrings(input->getValueString(), input->getType());
+        REQUIRE(value);
+        REQUIRE(value->getValueString() == parsed->getValueString());
+    }
+
+    // Verify that values are cached until their value or type changes.
+    mx::NodeDefPtr nodeDef = doc->addNodeDef("ND_cached_float", "float", "cached");
+    mx::InputPtr input = nodeDef->setInputValue("in", 0.5f);
+    mx::ConstValuePtr value = input->getConstValue();
+    REQUIRE(input->getConstValue() == value);
+    input->setValue(0.25f);
+    REQUIRE(input->getValue()->asA<float>() == 0.25f);
+    input->setAttribute(mx::ValueElement::VALUE_ATTRIBUTE, "2");
+    REQUIRE(input->getValue()->asA<float>() == 2.0f);
+    input->setType("integer");
+    REQUIRE(input->getValue()->asA<int>() == 2);
+    input->removeAttribute(mx::ValueElement::VALUE_ATTRIBUTE);
+    REQUIRE(!input->getValue());
+    input->copyContentFrom(nodeDef->addInput("other", "color3"));
+    input->setValueString("1, 0, 0");
+    REQUIRE(input->getValue()->asA<mx::Color3>() == mx::Color3(1.0f, 0.0f, 0.0f));
+    input->setValueString("0, 1, 0");
+    REQUIRE(input->getValue()->asA<mx::Color3>() == mx::Color3(0.0f, 1.0f, 0.0f));
+
+    // Verify that modifying a returned value does not affect the element.
+    mx::ValuePtr copy = input->getValue();
+    REQUIRE(copy != input->getConstValue());
+    std::static_pointer_cast<mx::TypedValue<mx::Color3>>(copy)->setData(mx::Color3(0.0f, 0.0f, 1.0f));
+    REQUIRE(input->getValue()->asA<mx::Color3>() == mx::Color3(0.0f, 1.0f, 0.0f));
+
+    // Verify that struct values, which depend on typedefs, are not cached.
+    mx::TypeDefPtr typeDef = doc->addTypeDef("cachedstruct");
+    typeDef->addMember("a")->setType("float");
+    mx::InputPtr structInput = nodeDef->addInput("structin", "cachedstruct");
+    structInput->setValueString("{1.0}");
+    REQUIRE(structInput->getConstValue()->isA<mx::AggregateValue>());
+    REQUIRE(structInput->getConstValue() != structInput->getConstValue());
+
+    // Verify that disabling caching releases cached values.
+    value = input->getConstValue();
+    doc->setValueCaching(false);
+    REQUIRE(input->getConstValue() != value);
+    REQUIRE(input->getConstValue() != input->getConstValue());
+    REQUIRE(input->getConstValue()->asA<mx::Color3>() == mx::Color3(0.0f, 1.0f, 0.0f));
+    doc->setValueCaching(true);
+    REQUIRE(input->getConstValue() == input->getConstValue());
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+    for (bool caching : { true, false })
+    {
+        doc->setValueCaching(caching);
+        BENCHMARK(std::string("Input values ") + (caching ? "with" : "without") + " caching")
+        {
+            size_t valueCount = 0;
+            for (mx::InputPtr libraryInput : inputs)
+            {
+                valueCount += libraryInput->getConstValue() ? 1 : 0;
+            }
+            return valueCount;
+        };
+    }
+#endif
+}
+
+TEST_CASE("Element pooling", "[document]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, mx::getDefaultDataSearchPath(), doc);
+    REQUIRE(!doc->getElementPooling());
+
+    // Verify that pooled documents match unpooled documents.
+    mx::DocumentPtr pooledDoc = mx::createDocument();
+    pooledDoc->setElementPooling(true);
+    REQUIRE(pooledDoc->getElementPooling());
+    mx::loadLibraries({ "libraries" }, mx::getDefaultDataSearchPath(), pooledDoc);
+    REQUIRE(pooledDoc->validate());
+    REQUIRE(mx::writeToXmlString(pooledDoc) == mx::writeToXmlString(doc));
+    mx::DocumentPtr copiedDoc = pooledDoc->copy();
+    REQUIRE(copiedDoc->getElementPooling());
+    REQUIRE(*copiedDoc == *pooledDoc);
+
+    // Verify that pooled elements may be removed, replaced and retained.
+    mx::NodeDefPtr nodeDef = pooledDoc->getNodeDefs().front();
+    const std::string nodeDefName = nodeDef->getName();
+    for (int i = 0; i < 100; i++)
+    {
+        pooledDoc->removeNodeDef(nodeDefName);
+        mx::NodeDefPtr newNodeDef = pooledDoc->addNodeDef(nodeDefName, "float", "pooled");
+        newNodeDef->setInputValue("in", 1.0f);
+    }
+    REQUIRE(pooledDoc->getNodeDef(nodeDefName)->getNodeString() == "pooled");
+    pooledDoc->setElementPooling(false);
+    mx::NodeGraphPtr unpooledGraph = pooledDoc->addNodeGraph();
+    pooledDoc = nullptr;
+    copiedDoc = nullptr;
+    REQUIRE(nodeDef->getName() == nodeDefName);
+    REQUIRE(!nodeDef->getChildren().empty());
+    REQUIRE(unpooledGraph->getChildren().empty());
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+    mx::DocumentPtr libraries = doc;
+    doc = nullptr;
+    for (bool pooling : { false, true })
+    {
+        BENCHMARK(std::string("Load and destroy libraries ") + (pooling ? "with" : "without") + " pooling")
+        {
+            mx::DocumentPtr benchDoc = mx::createDocument();
+            benchDoc->setElementPooling(pooling);
+            mx::loadLibraries({ "libraries" }, mx::getDefaultDataSearchPath(), benchDoc);
+            return benchDoc->getChildren().size();
+        };
+        BENCHMARK(std::string("Copy and destroy libraries ") + (pooling ? "with" : "without") + " pooling")
+        {
+            mx::DocumentPtr benchDoc = mx::createDocument();
+            benchDoc->setElementPooling(pooling);
+            benchDoc->copyContentFrom(libraries);
+            return benchDoc->getChildren().size();
+        };
+    }
+#endif
+}
+
+TEST_CASE("Parallel validation", "[document]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, mx::getDefaultDataSearchPath(), doc);
+    REQUIRE(doc->validate());
+
+    // Introduce errors throughout the document.
+    std::vector<mx::NodeDefPtr> nodeDefs = doc->getNodeDefs();
+    REQUIRE(nodeDefs.size() > 100);
+    for (size_t i = 10; i < nodeDefs.size(); i += 50)
+    {
+        nodeDefs[i]->addInput("invalid", "float")->setValueString("invalid");
+    }
+    std::string serialMessage;
+    REQUIRE(!doc->validate(&serialMessage));
+    REQUIRE(!serialMessage.empty());
+
+    // Verify that parallel validation reports the same messages in the same order.
+    mx::ValidationOptions options;
+    for (unsigned int threadCount : { 1u, 2u, 4u, 0u })
+    {
+        options.threadCount = threadCount;
+        std::string message;
+        REQUIRE(!doc->validate(&message, options));
+        REQUIRE(message == serialMessage);
+    }
+
+    // Verify that only the first error is reported when requested.
+    std::string firstError = serialMessage.substr(0, serialMessage.find('\n') + 1);
+    options.firstErrorOnly = true;
+    for (unsigned int threadCount : { 1u, 4u })
+    {
+        options.threadCount = threadCount;
+        std::string message;
+        REQUIRE(!doc->validate(&message, options));
+        REQUIRE(message == firstError);
+    }
+
+    // Verify that options do not persist beyond the call.
+    std::string message;
+    REQUIRE(!doc->validate(&message));
+    REQUIRE(message == serialMessage);
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+    for (size_t i = 10; i < nodeDefs.size(); i += 50)
+    {
+        nodeDefs[i]->removeInput("invalid");
+    }
+    REQUIRE(doc->validate());
+    options.firstErrorOnly = false;
+    for (unsigned int threadCount : { 1u, 4u })
+    {
+        options.threadCount = threadCount;
+        BENCHMARK("Validate libraries with " + std::to_string(threadCount) + " threads")
+        {
+            return doc->validate(nullptr, options);
+        };
+    }
+#endif
+}
+
+TEST_CASE("Content hashing", "[document]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, mx::getDefaultDataSearchPath(), doc);
+    mx::DocumentPtr doc2 = doc->copy();
+
+    // Verify that copies share a content hash and have no differences.
+    size_t hash = doc->getContentHash();
+    REQUIRE(hash != 0);
+    REQUIRE(doc2->getContentHash() == hash);
+    REQUIRE(doc->diff(doc2).empty());
+
+    // Verify that comments and attribute order are ignored.
+    doc2->addChildOfCategory(mx::CommentElement::CATEGORY)->setDocString("Comment");
+    mx::NodeDefPtr nodeDef = doc2->getNodeDefs().front();
+    const std::string nodeString = nodeDef->getNodeString();
+    nodeDef->removeAttribute(mx::NodeDef::NODE_ATTRIBUTE);
+    REQUIRE(doc2->getContentHash() != hash);
+    nodeDef->setNodeString(nodeString);
+    REQUIRE(doc2->getContentHash() == hash);
+
+    // Verify that edits are reported as the smallest differing subtrees.
+    mx::InputPtr input = nodeDef->getInputs().front();
+    std::string valueString = input->getValueString();
+    input->setValueString("modified");
+    mx::NodeGraphPtr addedGraph = doc2->addNodeGraph("added_graph");
+    const std::string removedName = doc2->getNodeDefs().back()->getName();
+    doc2->removeChild(removedName);
+    std::vector<mx::ElementDiff> diffs = doc->diff(doc2);
+    REQUIRE(diffs.size() == 3);
+    REQUIRE(diffs[0].first == doc->getDescendant(input->getNamePath()));
+    REQUIRE(diffs[0].second == input);
+    REQUIRE(diffs[1].first == doc->getChild(removedName));
+    REQUIRE(!diffs[1].second);
+    REQUIRE(!diffs[2].first);
+    REQUIRE(diffs[2].second == addedGraph);
+
+    // Verify that reverting the edits restores the original hash.
+    input->setValueString(valueString);
+    doc2->removeChild(addedGraph->getName());
+    doc2->addChildOfCategory(doc->getChild(removedName)->getCategory(), removedName)->copyContentFrom(doc->getChild(removedName));
+    doc2->setChildIndex(removedName, doc->getChildIndex(removedName));
+    REQUIRE(doc2->getContentHash() == hash);
+    REQUIRE(doc->diff(doc2).empty());
+
+    // Verify that reordered children are reported at their parent.
+    doc2->setChildIndex(removedName, 0);
+    diffs = doc->diff(doc2);
+    REQUIRE(diffs.size() == 1);
+    REQUIRE(diffs[0].first == doc);
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+    doc2 = doc->copy();
+    BENCHMARK("Compare libraries by equivalence")
+    {
+        return doc->isEquivalent(doc2, mx::ElementEquivalenceOptions());
+    };
+    BENCHMARK("Compare libraries by content hash")
+    {
+        return doc->getContentHash() == doc2->getContentHash();
+    };
+#endif
+}
+
 TEST_CASE("Document equivalence", "[document]")
 {
     mx::DocumentPtr doc = mx::createDocument();
@@ -40,6 +40,25 @@ TEST_CASE("Element", "[element]")
     REQUIRE(elem1->getTypedAttribute<bool>("customColor") == false);
     REQUIRE(elem1->getTypedAttribute<mx::Color3>("customFlag") == mx::Color3(0.0f));
 
+    // Modify attributes.
+    elem2->setAttribute("attr1", "value1");
+    elem2->setAttribute("attr2", "value2");
+    elem2->setAttribute("attr3", "value3");
+    elem2->setAttribute("attr1", "value4");
+    REQUIRE(elem2->getAttributeNames() == (std::vector<std::string>{ "attr1", "attr2", "attr3" }));
+    REQUIRE(elem2->getAttribute("attr1") == "value4");
+    elem2->removeAttribute("attr2");
+    REQUIRE(!elem2->hasAttribute("attr2"));
+    REQUIRE(elem2->getAttribute("attr2").empty());
+    REQUIRE(elem2->getAttributeNames() == (std::vector<std::string>{ "attr1", "attr3" }));
+    REQUIRE(elem2->getAttributeCount() == 2);
+    REQUIRE(elem2->getAttributeName(1) == "attr3");
+    REQUIRE(elem2->getAttributeValue(1) == elem2->getAttribute("attr3"));
+    REQUIRE(!elem2->hasAttribute("attrNeverSet"));
+    REQUIRE(elem1->getCategory() == elem2->getCategory());
+    elem2->removeAttribute("attr1");
+    elem2->removeAttribute("attr3");
+
     // Modify element names.
     elem1->setName("elem1");
     elem2->setName("elem2");
@@ -69,3 +88,108 @@ TEST_CASE("Element", "[element]")
     }
     REQUIRE_THROWS_AS(orphan->getDocument(), mx::ExceptionOrphanedElement);
 }
+
+TEST_CASE("Typed child queries", "[element]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    for (int i = 0; i < 1000; i++)
+    {
+        doc->addNodeDef();
+        doc->addNodeGraph();
+        doc->addNode(i % 2 ? "add" : "multiply");
+        doc->addLook();
+        doc->addChildOfCategory("custom");
+    }
+
+    // Return the children of the given element that are instances of the
+    // given class and category, by linear scan.
+    auto scanChildren = [](mx::ElementPtr elem, const std::string& category, auto* typeTag)
+    {
+        using T = std::remove_pointer_t<decltype(typeTag)>;
+        std::vector<std::shared_ptr<T>> children;
+        for (mx::ElementPtr child : elem->getChildren())
+        {
+            std::shared_ptr<T> instance = child->asA<T>();
+            if (instance && (category.empty() || child->getCategory() == category))
+            {
+                children.push_back(instance);
+            }
+        }
+        return children;
+    };
+
+    // Verify that indexed queries match a linear scan.
+    auto verifyQueries = [doc, scanChildren]()
+    {
+        REQUIRE(doc->getNodeDefs() == scanChildren(doc, mx::EMPTY_STRING, (mx::NodeDef*) nullptr));
+        REQUIRE(doc->getNodeGraphs() == scanChildren(doc, mx::EMPTY_STRING, (mx::NodeGraph*) nullptr));
+        REQUIRE(doc->getLooks() == scanChildren(doc, mx::EMPTY_STRING, (mx::Look*) nullptr));
+        REQUIRE(doc->getNodes() == scanChildren(doc, mx::EMPTY_STRING, (mx::Node*) nullptr));
+        REQUIRE(doc->getNodes("add") == scanChildren(doc, "add", (mx::Node*) nullptr));
+        REQUIRE(doc->getChildrenOfType<mx::Element>("custom") == scanChildren(doc, "custom", (mx::Element*) nullptr));
+        REQUIRE(doc->getChildrenOfType<mx::InterfaceElement>() == scanChildren(doc, mx::EMPTY_STRING, (mx::InterfaceElement*) nullptr));
+    };
+    verifyQueries();
+
+    // Reorder, remove, and recategorize children.
+    std::vector<mx::NodeDefPtr> nodeDefs = doc->getNodeDefs();
+    doc->setChildIndex(nodeDefs.back()->getName(), 0);
+    doc->setChildIndex(doc->getNodes("add")[10]->getName(), 3);
+    doc->removeChild(nodeDefs[5]->getName());
+    doc->changeChildCategory(doc->getNodes("multiply")[0], "add");
+    doc->getNodes("add")[20]->setCategory("multiply");
+    doc->getNodes("multiply")[5]->setCategory("add");
+    doc->getNodeGraphs()[0]->addNode("add");
+    verifyQueries();
+    REQUIRE(doc->getNodeDefs().size() == 999);
+    REQUIRE(doc->getNodeDefs()[0] == nodeDefs.back());
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+    BENCHMARK("Indexed typed child query")
+    {
+        return doc->getNodeDefs();
+    };
+    BENCHMARK("Scanned typed child query")
+    {
+        return scanChildren(doc, mx::EMPTY_STRING, (mx::NodeDef*) nullptr);
+    };
+#endif
+}
+
+TEST_CASE("Attribute queries", "[element]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    for (int i = 0; i < 1000; i++)
+    {
+        mx::NodePtr node = doc->addNode("image", mx::EMPTY_STRING, "color3");
+        node->setVersionString("1.0");
+        node->setColorSpace("srgb_texture");
+        node->setAttribute("uicolor", "1.0, 0.0, 0.0");
+        node->setDocString("An image node.");
+    }
+
+    for (mx::NodePtr node : doc->getNodes())
+    {
+        REQUIRE(node->getType() == "color3");
+        REQUIRE(node->getAttribute("uicolor") == "1.0, 0.0, 0.0");
+        REQUIRE(node->getAttributeNames().size() == 5);
+    }
+    mx::DocumentPtr copy = doc->copy();
+    REQUIRE(*copy == *doc);
+    copy->getNodes()[0]->setColorSpace("lin_rec709");
+    REQUIRE(*copy != *doc);
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+    BENCHMARK("Attribute lookups")
+    {
+        size_t matchCount = 0;
+        for (mx::NodePtr node : doc->getNodes())
+        {
+            matchCount += node->getType() == "color3" ? 1 : 0;
+            matchCount += node->hasAttribute(mx::Element::DOC_ATTRIBUTE) ? 1 : 0;
+            matchCount += node->getColorSpace().empty() ? 0 : 1;
+        }
+        return matchCount;
+    };
+#endif
+}
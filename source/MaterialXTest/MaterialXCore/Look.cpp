@@ -123,3 +123,104 @@ TEST_CASE("LookGroup", "[look]")
     lookGroups = doc->getLookGroups();
     REQUIRE(lookGroups.size() == 0);
 }
+
+TEST_CASE("Geometry binding resolver", "[look]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+
+    // Create materials bound to a hierarchy of geometry through geometry
+    // strings and nested collections.
+    const int ASSET_COUNT = 20;
+    const int PART_COUNT = 10;
+    std::vector<mx::NodePtr> materials;
+    for (int i = 0; i < 4; i++)
+    {
+        mx::NodePtr shaderNode = doc->addNode("standard_surface", "", mx::SURFACE_SHADER_TYPE_STRING);
+        materials.push_back(doc->addMaterialNode("", shaderNode));
+    }
+    mx::LookPtr look = doc->addLook();
+    mx::CollectionPtr previousCollection;
+    for (int i = 0; i < ASSET_COUNT; i++)
+    {
+        const std::string asset = "/scene/asset" + std::to_string(i);
+        const std::string& material = materials[i % materials.size()]->getName();
+        mx::MaterialAssignPtr geomAssign = look->addMaterialAssign("", material);
+        geomAssign->setGeom(asset + "/part" + std::to_string(i % PART_COUNT) + ", " + asset + "/part0/sub");
+
+        mx::CollectionPtr collection = doc->addCollection();
+        collection->setIncludeGeom(asset);
+        collection->setExcludeGeom(asset + "/part" + std::to_string((i + 1) % PART_COUNT));
+        if (previousCollection && i % 3)
+        {
+            collection->setIncludeCollection(previousCollection);
+        }
+        previousCollection = collection;
+        mx::MaterialAssignPtr collectionAssign = look->addMaterialAssign("", material);
+        collectionAssign->setCollection(collection);
+    }
+    look->addMaterialAssign("", materials[0]->getName())->setGeom(mx::UNIVERSAL_GEOM_NAME);
+
+    mx::StringVec geoms = { "", mx::UNIVERSAL_GEOM_NAME, "/scene", "/other", "/scene/asset1, /scene/asset2/part3" };
+    for (int i = 0; i < ASSET_COUNT + 2; i++)
+    {
+        const std::string asset = "/scene/asset" + std::to_string(i);
+        geoms.push_back(asset);
+        for (int j = 0; j < PART_COUNT; j++)
+        {
+            geoms.push_back(asset + "/part" + std::to_string(j));
+            geoms.push_back(asset + "/part" + std::to_string(j) + "/sub");
+        }
+    }
+
+    // Verify that resolved bindings match those of getGeometryBindings.
+    mx::GeometryBindingResolver resolver(doc);
+    REQUIRE(resolver.getAssignCount() == look->getMaterialAssigns().size());
+    for (const std::string& geom : geoms)
+    {
+        std::vector<mx::MaterialAssignPtr> allBindings;
+        for (mx::NodePtr material : materials)
+        {
+            std::vector<mx::MaterialAssignPtr> bindings = mx::getGeometryBindings(material, geom);
+            REQUIRE(resolver.getBindings(geom, material) == bindings);
+            allBindings.insert(allBindings.end(), bindings.begin(), bindings.end());
+        }
+        REQUIRE(resolver.getBindings(geom).size() == allBindings.size());
+    }
+    std::vector<std::vector<mx::MaterialAssignPtr>> batchBindings = resolver.getBatchBindings(geoms, materials[1]);
+    REQUIRE(batchBindings.size() == geoms.size());
+    for (size_t i = 0; i < geoms.size(); i++)
+    {
+        REQUIRE(batchBindings[i] == mx::getGeometryBindings(materials[1], geoms[i]));
+    }
+
+    // Verify that collection cycles are reported when they are reached.
+    mx::CollectionPtr cycleCollection = doc->addCollection();
+    cycleCollection->setIncludeGeom("/cycle");
+    cycleCollection->setIncludeCollection(cycleCollection);
+    look->addMaterialAssign("", materials[0]->getName())->setCollection(cycleCollection);
+    mx::GeometryBindingResolver cycleResolver(doc);
+    REQUIRE(cycleResolver.getBindings("/cycle/a").size() == 2);
+    REQUIRE_THROWS_AS(cycleResolver.getBindings("/scene"), mx::ExceptionFoundCycle);
+    REQUIRE_THROWS_AS(mx::getGeometryBindings(materials[0], "/scene"), mx::ExceptionFoundCycle);
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+    BENCHMARK("Geometry bindings by search")
+    {
+        size_t bindingCount = 0;
+        for (const std::string& geom : geoms)
+        {
+            bindingCount += mx::getGeometryBindings(materials[1], geom).size();
+        }
+        return bindingCount;
+    };
+    BENCHMARK("Geometry bindings by resolver")
+    {
+        size_t bindingCount = 0;
+        for (const auto& bindings : resolver.getBatchBindings(geoms, materials[1]))
+        {
+            bindingCount += bindings.size();
+        }
+        return bindingCount;
+    };
+#endif
+}
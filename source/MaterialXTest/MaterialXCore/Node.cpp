@@ -310,6 +310,225 @@ TEST_CASE("Inheritance", "[nodedef]")
         nodedefSpecularInput->getAttribute(mx::ValueElement::VALUE_ATTRIBUTE));
 }
 
+TEST_CASE("Node definition resolution", "[nodedef]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, doc);
+
+    // Resolve the nodedef of a node by exhaustive search.
+    auto findNodeDef = [](mx::NodePtr node, const std::string& target, bool allowRoughMatch)
+    {
+        mx::DocumentPtr nodeDoc = node->getDocument();
+        std::vector<mx::NodeDefPtr> nodeDefs = nodeDoc->getMatchingNodeDefs(node->getQualifiedName(node->getCategory()));
+        std::vector<mx::NodeDefPtr> secondary = nodeDoc->getMatchingNodeDefs(node->getCategory());
+        nodeDefs.insert(nodeDefs.end(), secondary.begin(), secondary.end());
+        mx::NodeDefPtr roughMatch;
+        for (mx::NodeDefPtr nodeDef : nodeDefs)
+        {
+            if (!mx::targetStringsMatch(nodeDef->getTarget(), target) ||
+                !nodeDef->isVersionCompatible(node->getVersionString()) ||
+                nodeDef->getType() != node->getType())
+            {
+                continue;
+            }
+            if (node->hasExactInputMatch(nodeDef))
+            {
+                return nodeDef;
+            }
+            if (allowRoughMatch && !roughMatch)
+            {
+                roughMatch = nodeDef;
+            }
+        }
+        return roughMatch;
+    };
+
+    // Verify indexed resolution for all nodes in the data libraries.
+    std::vector<mx::NodePtr> nodes;
+    for (mx::ElementPtr elem : doc->traverseTree())
+    {
+        mx::NodePtr node = elem->asA<mx::Node>();
+        if (node && !node->hasNodeDefString())
+        {
+            nodes.push_back(node);
+        }
+    }
+    REQUIRE(!nodes.empty());
+    for (mx::NodePtr node : nodes)
+    {
+        for (const std::string& target : { std::string(), std::string("genglsl"), std::string("genosl") })
+        {
+            REQUIRE(node->getNodeDef(target) == findNodeDef(node, target, false));
+            REQUIRE(node->getNodeDef(target, true) == findNodeDef(node, target, true));
+        }
+    }
+
+    // Verify resolution through a data library.
+    mx::DocumentPtr materialDoc = mx::createDocument();
+    materialDoc->setDataLibrary(doc);
+    mx::NodePtr multiply = materialDoc->addNode("multiply", "multiply1", "color3");
+    multiply->setInputValue("in2", 0.5f);
+    REQUIRE(multiply->getNodeDef() == doc->getNodeDef("ND_multiply_color3FA"));
+
+    // Verify that edits to nodedefs are reflected in resolution.
+    mx::NodeDefPtr nodeDef = doc->addNodeDef("ND_custom_float", "float", "custom");
+    mx::InputPtr nodeDefInput = nodeDef->addInput("in", "float");
+    mx::NodePtr custom = materialDoc->addNode("custom", "custom1", "float");
+    custom->setInputValue("in", 1.0f);
+    REQUIRE(custom->getNodeDef() == nodeDef);
+    nodeDefInput->setType("color3");
+    REQUIRE(custom->getNodeDef() == nullptr);
+    REQUIRE(custom->getNodeDef(mx::EMPTY_STRING, true) == nodeDef);
+    nodeDefInput->setType("float");
+    nodeDef->setVersionString("2.0");
+    REQUIRE(custom->getNodeDef() == nullptr);
+    custom->setVersionString("2.0");
+    REQUIRE(custom->getNodeDef() == nodeDef);
+    mx::NodeDefPtr derived = doc->addNodeDef("ND_custom_derived", "float", "custom");
+    derived->addInput("extra", "float");
+    derived->setVersionString("3.0");
+    custom->setVersionString("3.0");
+    custom->setInputValue("in", 1.0f);
+    REQUIRE(custom->getNodeDef() == nullptr);
+    derived->setInheritString(nodeDef->getName());
+    REQUIRE(custom->getNodeDef() == derived);
+    nodeDefInput->setName("renamed");
+    REQUIRE(custom->getNodeDef() == nullptr);
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+    BENCHMARK("Resolve library node definitions")
+    {
+        size_t matchCount = 0;
+        for (mx::NodePtr node : nodes)
+        {
+            matchCount += node->getNodeDef() ? 1 : 0;
+        }
+        return matchCount;
+    };
+    BENCHMARK("Resolve library node definitions by exhaustive search")
+    {
+        size_t matchCount = 0;
+        for (mx::NodePtr node : nodes)
+        {
+            matchCount += findNodeDef(node, mx::EMPTY_STRING, false) ? 1 : 0;
+        }
+        return matchCount;
+    };
+#endif
+}
+
+TEST_CASE("Active interfaces", "[nodedef]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, doc);
+
+    // Compute the active inputs of an interface by traversing its inheritance.
+    auto findActiveInputs = [](mx::InterfaceElementPtr interfaceElem)
+    {
+        std::vector<mx::InputPtr> activeInputs;
+        mx::StringSet activeNames;
+        for (mx::ConstElementPtr elem : interfaceElem->traverseInheritance())
+        {
+            for (mx::InputPtr input : elem->asA<mx::InterfaceElement>()->getInputs())
+            {
+                if (activeNames.insert(input->getName()).second)
+                {
+                    activeInputs.push_back(input);
+                }
+            }
+        }
+        return activeInputs;
+    };
+
+    // Verify active interfaces for all nodedefs in the data libraries.
+    for (mx::NodeDefPtr nodeDef : doc->getNodeDefs())
+    {
+        std::vector<mx::InputPtr> activeInputs = findActiveInputs(nodeDef);
+        REQUIRE(nodeDef->getActiveInputs() == activeInputs);
+        for (mx::InputPtr input : activeInputs)
+        {
+            REQUIRE(nodeDef->getActiveInput(input->getName()) == input);
+            REQUIRE(nodeDef->getActiveValueElement(input->getName()) == input);
+        }
+    }
+
+    // Verify that edits are reflected in active interfaces.
+    mx::NodeDefPtr base = doc->addNodeDef("ND_base_float", "float", "base");
+    base->addInput("in1", "float");
+    base->addToken("token1");
+    mx::NodeDefPtr derived = doc->addNodeDef("ND_derived_float", "float", "derived");
+    derived->addInput("in2", "float");
+    REQUIRE(derived->getActiveInputs().size() == 1);
+    derived->setInheritString(base->getName());
+    REQUIRE(derived->getActiveInputs() == findActiveInputs(derived));
+    REQUIRE(derived->getActiveInput("in1") == base->getInput("in1"));
+    REQUIRE(derived->getActiveToken("token1") == base->getToken("token1"));
+    mx::InputPtr in3 = base->addInput("in3", "float");
+    REQUIRE(derived->getActiveInput("in3") == in3);
+    mx::InputPtr override = derived->addInput("in3", "float");
+    REQUIRE(derived->getActiveInput("in3") == override);
+    REQUIRE(derived->getActiveInputs() == findActiveInputs(derived));
+    in3->setName("in4");
+    REQUIRE(derived->getActiveInput("in4") == in3);
+    base->removeInput("in4");
+    REQUIRE(!derived->getActiveInput("in4"));
+    REQUIRE(derived->getActiveOutputs().size() == 1);
+    derived->removeAttribute(mx::Element::INHERIT_ATTRIBUTE);
+    REQUIRE(!derived->getActiveInput("in1"));
+    REQUIRE(derived->getActiveInputs() == findActiveInputs(derived));
+
+    // Verify that active interfaces follow a change of data library.
+    mx::DocumentPtr lib1 = mx::createDocument();
+    lib1->addNodeDef("ND_base", "float", "base")->addInput("x", "float");
+    lib1->addNodeDef("ND_extra", "float", "extra");
+    mx::DocumentPtr lib2 = mx::createDocument();
+    lib2->addNodeDef("ND_base", "float", "base")->addInput("y", "float");
+    mx::DocumentPtr libDoc = mx::createDocument();
+    mx::NodeDefPtr child = libDoc->addNodeDef("ND_child", "float", "child");
+    child->setInheritString("ND_base");
+    libDoc->setDataLibrary(lib1);
+    REQUIRE(child->getActiveInput("x"));
+    libDoc->setDataLibrary(lib2);
+    REQUIRE(!child->getActiveInput("x"));
+    REQUIRE(child->getActiveInput("y"));
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+    for (const std::string& nodeDefName : { std::string("ND_standard_surface_surfaceshader"),
+                                            std::string("ND_open_pbr_surface_surfaceshader") })
+    {
+        mx::NodeDefPtr nodeDef = doc->getNodeDef(nodeDefName);
+        REQUIRE(nodeDef);
+        BENCHMARK("Active inputs of " + nodeDefName)
+        {
+            size_t inputCount = 0;
+            for (mx::InputPtr input : nodeDef->getActiveInputs())
+            {
+                inputCount += nodeDef->getActiveInput(input->getName()) ? 1 : 0;
+            }
+            return inputCount;
+        };
+        BENCHMARK("Active inputs of " + nodeDefName + " by traversal")
+        {
+            size_t inputCount = 0;
+            for (mx::InputPtr input : findActiveInputs(nodeDef))
+            {
+                for (mx::ConstElementPtr elem : nodeDef->traverseInheritance())
+                {
+                    if (elem->asA<mx::InterfaceElement>()->getInput(input->getName()))
+                    {
+                        inputCount++;
+                        break;
+                    }
+                }
+            }
+            return inputCount;
+        };
+    }
+#endif
+}
+
 TEST_CASE("Topological sort", "[nodegraph]")
 {
     // Create a document.
@@ -191,3 +191,77 @@ TEST_CASE("InterGraph Traversal", "[traversal]")
         }
     }
 }
+
+TEST_CASE("Traversal bookkeeping", "[traversal]")
+{
+    // Verify element tuple sets against a reference set, across the
+    // transition from inline to hashed storage.
+    mx::DocumentPtr doc = mx::createDocument();
+    std::vector<const mx::Element*> elems;
+    for (int i = 0; i < 200; i++)
+    {
+        elems.push_back(doc->addChildOfCategory("generic").get());
+    }
+    mx::internal::ElementTupleSet<2, 4> tupleSet;
+    std::set<std::array<const mx::Element*, 2>> referenceSet;
+    for (size_t i = 0; i < 2000; i++)
+    {
+        std::array<const mx::Element*, 2> tuple = { elems[(i * 7) % elems.size()], elems[(i * 13) % 17] };
+        if (i % 3 == 2)
+        {
+            tupleSet.erase(tuple);
+            referenceSet.erase(tuple);
+        }
+        else
+        {
+            REQUIRE(tupleSet.insert(tuple) == referenceSet.insert(tuple).second);
+        }
+        REQUIRE(tupleSet.size() == referenceSet.size());
+    }
+    for (const auto& tuple : referenceSet)
+    {
+        REQUIRE(tupleSet.contains(tuple));
+    }
+    size_t visitCount = 0;
+    tupleSet.forEach([&referenceSet, &visitCount](const std::array<const mx::Element*, 2>& tuple)
+    {
+        REQUIRE(referenceSet.count(tuple));
+        visitCount++;
+    });
+    REQUIRE(visitCount == referenceSet.size());
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+    // Load all example and test suite materials.
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    std::vector<mx::DocumentPtr> documents;
+    mx::StringVec documentPaths;
+    mx::loadDocuments(searchPath.find("resources/Materials"), searchPath, {}, {}, documents, documentPaths);
+    REQUIRE(!documents.empty());
+    std::vector<mx::NodePtr> materials;
+    for (mx::DocumentPtr materialDoc : documents)
+    {
+        std::vector<mx::NodePtr> materialNodes = materialDoc->getMaterialNodes();
+        materials.insert(materials.end(), materialNodes.begin(), materialNodes.end());
+    }
+    REQUIRE(!materials.empty());
+
+    BENCHMARK("Traverse material graphs")
+    {
+        size_t edgeCount = 0;
+        for (mx::NodePtr material : materials)
+        {
+            try
+            {
+                for (mx::Edge edge : material->traverseGraph())
+                {
+                    edgeCount += edge.getUpstreamElement() ? 1 : 0;
+                }
+            }
+            catch (mx::ExceptionFoundCycle&)
+            {
+            }
+        }
+        return edgeCount;
+    };
+#endif
+}
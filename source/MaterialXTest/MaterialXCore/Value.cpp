@@ -8,6 +8,9 @@
 #include <MaterialXCore/Util.h>
 #include <MaterialXCore/Value.h>
 
+#include <limits>
+#include <sstream>
+
 namespace mx = MaterialX;
 
 template<class T> void testTypedValue(const T& v1, const T& v2)
@@ -89,6 +92,109 @@ TEST_CASE("Value strings", "[value]")
     REQUIRE(mx::parseStructValueString("{1;2;{3};4}") == (std::vector<std::string>{"1","2","{3}","4"}));
 }
 
+TEST_CASE("Value string conversions", "[value]")
+{
+    // Format a float with a classic-locale stream, as a reference.
+    auto streamFloat = [](float value, mx::Value::FloatFormat format, int precision)
+    {
+        std::ostringstream ss;
+        ss.imbue(std::locale::classic());
+        ss.setf(format == mx::Value::FloatFormatFixed ? std::ios_base::fixed :
+                format == mx::Value::FloatFormatScientific ? std::ios_base::scientific :
+                std::ios_base::fmtflags(0), std::ios_base::floatfield);
+        ss.precision(precision);
+        ss << value;
+        return ss.str();
+    };
+
+    // Verify that formatting matches stream output for all float formats.
+    const std::vector<float> values = { 0.0f, -0.0f, 1.0f, -1.5f, 0.1234567f, 1.0f / 3.0f, 100.0f, 12345.678f,
+                                        1.0e-7f, 3.0e20f, -2.5e-30f, std::numeric_limits<float>::max(),
+                                        std::numeric_limits<float>::min(), std::numeric_limits<float>::denorm_min() };
+    for (mx::Value::FloatFormat format : { mx::Value::FloatFormatDefault, mx::Value::FloatFormatFixed, mx::Value::FloatFormatScientific })
+    {
+        for (int precision : { 0, 1, 3, 6, 9, 17 })
+        {
+            mx::ScopedFloatFormatting fmt(format, precision);
+            for (float value : values)
+            {
+                REQUIRE(mx::toValueString(value) == streamFloat(value, format, precision));
+            }
+        }
+    }
+    REQUIRE(mx::toValueString(-42) == "-42");
+    REQUIRE(mx::toValueString(mx::Matrix33::IDENTITY) == "1, 0, 0, 0, 1, 0, 0, 0, 1");
+    REQUIRE(mx::toValueString(mx::FloatVec{ 0.5f, 1.0f }) == "0.5, 1");
+
+    // Verify that parsing round-trips values at full precision.
+    {
+        mx::ScopedFloatFormatting fmt(mx::Value::FloatFormatDefault, 9);
+        for (float value : values)
+        {
+            REQUIRE(mx::fromValueString<float>(mx::toValueString(value)) == value);
+        }
+    }
+
+    // Verify that parsing follows formatted stream input.
+    REQUIRE(mx::fromValueString<float>(" +2.5") == 2.5f);
+    REQUIRE(mx::fromValueString<float>(".5") == 0.5f);
+    REQUIRE(mx::fromValueString<float>("1e3") == 1000.0f);
+    REQUIRE(mx::fromValueString<float>("-1.5abc") == -1.5f);
+    REQUIRE(mx::fromValueString<int>("12.5") == 12);
+    REQUIRE(mx::fromValueString<int>("+7") == 7);
+    REQUIRE(mx::fromValueString<mx::Vector3>("1,2 3") == mx::Vector3(1.0f, 2.0f, 3.0f));
+    REQUIRE(mx::fromValueString<mx::Matrix33>("1, 2, 3, 4, 5, 6, 7, 8, 9")[1][0] == 4.0f);
+    REQUIRE(mx::fromValueString<mx::FloatVec>(" 1 , 2.5,3 ") == (mx::FloatVec{ 1.0f, 2.5f, 3.0f }));
+    REQUIRE(mx::fromValueString<mx::StringVec>("a b, c") == (mx::StringVec{ "a b", "c" }));
+    REQUIRE_THROWS_AS(mx::fromValueString<float>(""), mx::ExceptionTypeError);
+    REQUIRE_THROWS_AS(mx::fromValueString<float>("inf"), mx::ExceptionTypeError);
+    REQUIRE_THROWS_AS(mx::fromValueString<float>("nan"), mx::ExceptionTypeError);
+    REQUIRE_THROWS_AS(mx::fromValueString<float>("1e"), mx::ExceptionTypeError);
+    REQUIRE_THROWS_AS(mx::fromValueString<float>("1e50"), mx::ExceptionTypeError);
+    REQUIRE_THROWS_AS(mx::fromValueString<int>("99999999999"), mx::ExceptionTypeError);
+    REQUIRE_THROWS_AS(mx::fromValueString<mx::Color3>("1, 2, 3, 4"), mx::ExceptionTypeError);
+    REQUIRE_THROWS_AS(mx::fromValueString<mx::FloatVec>("1, , 2"), mx::ExceptionTypeError);
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+    const std::string color3String = "0.8, 0.4, 0.15";
+    const std::string vector4String = "1.5, -2.25, 3.125, 0.0001";
+    const std::string matrix44String = mx::toValueString(mx::Matrix44(0.75f));
+    const std::string floatArrayString = mx::toValueString(mx::FloatVec(64, 0.125f));
+    BENCHMARK("Parse color3 value")
+    {
+        return mx::fromValueString<mx::Color3>(color3String);
+    };
+    BENCHMARK("Parse vector4 value")
+    {
+        return mx::fromValueString<mx::Vector4>(vector4String);
+    };
+    BENCHMARK("Parse matrix44 value")
+    {
+        return mx::fromValueString<mx::Matrix44>(matrix44String);
+    };
+    BENCHMARK("Parse floatarray value")
+    {
+        return mx::fromValueString<mx::FloatVec>(floatArrayString);
+    };
+    BENCHMARK("Format color3 value")
+    {
+        return mx::toValueString(mx::Color3(0.8f, 0.4f, 0.15f));
+    };
+    BENCHMARK("Format vector4 value")
+    {
+        return mx::toValueString(mx::Vector4(1.5f, -2.25f, 3.125f, 0.0001f));
+    };
+    BENCHMARK("Format matrix44 value")
+    {
+        return mx::toValueString(mx::Matrix44(0.75f));
+    };
+    BENCHMARK("Format floatarray value")
+    {
+        return mx::toValueString(mx::FloatVec(64, 0.125f));
+    };
+#endif
+}
+
 TEST_CASE("Typed values", "[value]")
 {
     // Base types
@@ -6,8 +6,11 @@
 #include <MaterialXTest/External/Catch/catch.hpp>
 
 #include <MaterialXFormat/File.h>
+#include <MaterialXFormat/FileCache.h>
 #include <MaterialXFormat/Util.h>
 
+#include <fstream>
+
 namespace mx = MaterialX;
 
 TEST_CASE("Syntactic operations", "[file]")
@@ -67,6 +70,69 @@ TEST_CASE("File search path operations", "[file]")
     }
 }
 
+TEST_CASE("File search cache", "[file]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::FileSearchCachePtr cache = mx::FileSearchCache::create();
+
+    // Resolved paths match those of the search path, and are reused.
+    const mx::FilePath filename = "libraries/stdlib/stdlib_defs.mtlx";
+    REQUIRE(cache->find(filename, searchPath) == searchPath.find(filename));
+    REQUIRE(cache->find(filename, searchPath) == searchPath.find(filename));
+    mx::FileSearchCacheStatistics stats = cache->getStatistics();
+    REQUIRE(stats.misses == 1);
+    REQUIRE(stats.hits == 1);
+    REQUIRE(stats.syscallsAvoided == stats.syscalls);
+
+    // Local paths are checked before the search path.
+    mx::FilePath localPath = searchPath.find("libraries/stdlib");
+    REQUIRE(cache->find("stdlib_defs.mtlx", searchPath, localPath) == localPath / "stdlib_defs.mtlx");
+
+    // Unresolved paths are cached until invalidated.
+    mx::FilePath cachePath = mx::FilePath::getCurrentPath() / "file_search_cache";
+    cachePath.createDirectory();
+    mx::FilePath newFile = cachePath / "new_file.txt";
+    mx::FilePath otherFile = cachePath / "other_file.txt";
+    std::remove(newFile.asString().c_str());
+    std::remove(otherFile.asString().c_str());
+    REQUIRE(cache->find("new_file.txt", searchPath, cachePath) == "new_file.txt");
+    REQUIRE(!cache->exists(newFile));
+    std::ofstream(newFile.asString()) << "new";
+    REQUIRE(cache->find("new_file.txt", searchPath, cachePath) == "new_file.txt");
+    REQUIRE(!cache->exists(newFile));
+    cache->invalidate(newFile);
+    REQUIRE(cache->find("new_file.txt", searchPath, cachePath) == newFile);
+    REQUIRE(cache->exists(newFile));
+    REQUIRE(cache->find(filename, searchPath) == searchPath.find(filename));
+
+    // Modification stamps are cached until invalidated.
+    const size_t stamp = cache->getModificationStamp(newFile);
+    REQUIRE(stamp == newFile.getModificationStamp());
+    cache->resetStatistics();
+    REQUIRE(cache->getModificationStamp(newFile) == stamp);
+    REQUIRE(cache->getStatistics().syscallsAvoided == 1);
+    REQUIRE(!cache->getModificationStamp(otherFile));
+    std::ofstream(otherFile.asString()) << "other";
+    REQUIRE(!cache->getModificationStamp(otherFile));
+    cache->invalidate(otherFile);
+    REQUIRE(cache->getModificationStamp(otherFile) == otherFile.getModificationStamp());
+    std::remove(otherFile.asString().c_str());
+    cache->invalidate(otherFile);
+
+    // Directory listings are cached when snapshots are enabled.
+    cache->setDirectorySnapshots(true);
+    cache->resetStatistics();
+    REQUIRE(cache->getFilesInDirectory(cachePath, "txt").size() == 1);
+    std::ofstream(otherFile.asString()) << "other";
+    REQUIRE(cache->getFilesInDirectory(cachePath, "txt").size() == 1);
+    REQUIRE(cache->getStatistics().hits == 1);
+    cache->invalidate(otherFile);
+    REQUIRE(cache->getFilesInDirectory(cachePath, "txt").size() == 2);
+    REQUIRE(cache->getSubDirectories(localPath) == localPath.getSubDirectories());
+    REQUIRE(cache->getSubDirectories(localPath) == localPath.getSubDirectories());
+    REQUIRE(cache->getStatistics().hits == 2);
+}
+
 TEST_CASE("Flatten filenames", "[file]")
 {
     const mx::FilePath TEST_FILE_PREFIX_STRING("resources\\Images\\");
@@ -5,10 +5,13 @@
 
 #include <MaterialXTest/External/Catch/catch.hpp>
 
+#include <MaterialXFormat/BinaryIo.h>
 #include <MaterialXFormat/Environ.h>
 #include <MaterialXFormat/Util.h>
 #include <MaterialXFormat/XmlIo.h>
 
+#include <thread>
+
 namespace mx = MaterialX;
 
 TEST_CASE("Load content", "[xmlio]")
@@ -239,6 +242,206 @@ TEST_CASE("Load content", "[xmlio]")
     REQUIRE_THROWS_AS(mx::readFromXmlFile(nonExistentDoc, "NonExistent.mtlx", mx::FileSearchPath(), &readOptions), mx::ExceptionFileMissing);
 }
 
+TEST_CASE("Load libraries", "[xmlio]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+
+    // Load the data libraries serially.
+    mx::DocumentPtr serialDoc = mx::createDocument();
+    mx::LibraryLoadStatistics serialStats;
+    mx::StringSet serialFiles = mx::loadLibraries({ "libraries" }, searchPath, serialDoc, mx::StringSet(), nullptr, nullptr, &serialStats);
+    REQUIRE(serialStats.fileCount == serialFiles.size());
+    REQUIRE(serialStats.fileCount > 0);
+
+    // Load the data libraries concurrently, verifying that the results are identical.
+    mx::DocumentPtr parallelDoc = mx::createDocument();
+    mx::LibraryLoadOptions loadOptions;
+    loadOptions.threadCount = 4;
+    mx::LibraryLoadStatistics parallelStats;
+    mx::StringSet parallelFiles = mx::loadLibraries({ "libraries" }, searchPath, parallelDoc, mx::StringSet(), nullptr, &loadOptions, &parallelStats);
+    REQUIRE(parallelFiles == serialFiles);
+    REQUIRE(parallelStats.fileCount == serialStats.fileCount);
+    REQUIRE(*parallelDoc == *serialDoc);
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+    BENCHMARK("Load libraries serially")
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        return mx::loadLibraries({ "libraries" }, searchPath, doc);
+    };
+    loadOptions.threadCount = 0;
+    BENCHMARK("Load libraries concurrently")
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        return mx::loadLibraries({ "libraries" }, searchPath, doc, mx::StringSet(), nullptr, &loadOptions);
+    };
+#endif
+}
+
+TEST_CASE("Binary snapshots", "[xmlio]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr libDoc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libDoc);
+
+    // Write the data libraries to a binary snapshot and read them back.
+    std::string snapshot = mx::writeToBinaryString(libDoc);
+    mx::DocumentPtr snapshotDoc = mx::createDocument();
+    mx::readFromBinaryBuffer(snapshotDoc, snapshot.data(), snapshot.size());
+    REQUIRE(*snapshotDoc == *libDoc);
+    REQUIRE(snapshotDoc->getNodeDefs().size() == libDoc->getNodeDefs().size());
+    for (mx::ElementPtr elem : libDoc->traverseTree())
+    {
+        mx::ElementPtr snapshotElem = snapshotDoc->getDescendant(elem->getNamePath());
+        REQUIRE(snapshotElem);
+        REQUIRE(snapshotElem->getSourceUri() == elem->getSourceUri());
+    }
+    REQUIRE(snapshotDoc->validate());
+
+    // Round-trip an example document through a snapshot file.
+    mx::FilePath examplePath = searchPath.find("resources/Materials/Examples/StandardSurface/standard_surface_chess_set.mtlx");
+    mx::DocumentPtr exampleDoc = mx::createDocument();
+    mx::readFromXmlFile(exampleDoc, examplePath);
+    mx::FilePath snapshotPath = mx::FilePath("standard_surface_chess_set." + mx::MTLX_BINARY_EXTENSION);
+    mx::writeToBinaryFile(exampleDoc, snapshotPath);
+    mx::DocumentPtr exampleSnapshotDoc = mx::createDocument();
+    mx::readFromBinaryFile(exampleSnapshotDoc, snapshotPath);
+    REQUIRE(*exampleSnapshotDoc == *exampleDoc);
+    REQUIRE(mx::writeToXmlString(exampleSnapshotDoc) == mx::writeToXmlString(exampleDoc));
+
+    // Verify that truncated and invalid snapshots are rejected.
+    for (size_t size : { (size_t) 0, (size_t) 4, snapshot.size() / 2, snapshot.size() - 1 })
+    {
+        mx::DocumentPtr truncatedDoc = mx::createDocument();
+        REQUIRE_THROWS_AS(mx::readFromBinaryBuffer(truncatedDoc, snapshot.data(), size), mx::ExceptionParseError);
+    }
+    std::string invalid = snapshot;
+    invalid[0] = 'X';
+    mx::DocumentPtr invalidDoc = mx::createDocument();
+    REQUIRE_THROWS_AS(mx::readFromBinaryBuffer(invalidDoc, invalid.data(), invalid.size()), mx::ExceptionParseError);
+    REQUIRE_THROWS_AS(mx::readFromBinaryFile(invalidDoc, "NonExistent." + mx::MTLX_BINARY_EXTENSION), mx::ExceptionFileMissing);
+#if defined(__linux__)
+    // Verify that failed writes are reported.
+    REQUIRE_THROWS_AS(mx::writeToBinaryFile(exampleDoc, "/dev/full"), mx::Exception);
+#endif
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+    std::string libXml = mx::writeToXmlString(libDoc);
+    BENCHMARK("Read libraries from XML")
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromXmlString(doc, libXml);
+        return doc;
+    };
+    BENCHMARK("Read libraries from binary snapshot")
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromBinaryBuffer(doc, snapshot.data(), snapshot.size());
+        return doc;
+    };
+#endif
+}
+
+TEST_CASE("Shared data library", "[xmlio]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr libDoc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libDoc);
+
+    // Freeze the data library, verifying that it can no longer be modified.
+    libDoc->freeze();
+    REQUIRE(libDoc->isFrozen());
+    REQUIRE_THROWS_AS(libDoc->addNodeDef("ND_frozen"), mx::Exception);
+    REQUIRE_THROWS_AS(libDoc->removeNodeDef("ND_add_float"), mx::Exception);
+    REQUIRE_THROWS_AS(libDoc->getNodeDef("ND_add_float")->setName("ND_renamed"), mx::Exception);
+    REQUIRE_THROWS_AS(libDoc->getNodeDef("ND_add_float")->setNodeString("subtract"), mx::Exception);
+    REQUIRE_THROWS_AS(libDoc->getNodeDef("ND_add_float")->setDocString("frozen"), mx::Exception);
+    REQUIRE_THROWS_AS(libDoc->getNodeDef("ND_add_float")->removeAttribute(mx::NodeDef::NODE_ATTRIBUTE), mx::Exception);
+    REQUIRE_THROWS_AS(libDoc->getNodeDef("ND_add_float")->getInput("in1")->setValue(1.0f), mx::Exception);
+    REQUIRE(libDoc->getNodeDef("ND_add_float"));
+    REQUIRE(libDoc->getNodeDef("ND_add_float")->getNodeString() == "add");
+    REQUIRE(libDoc->validate());
+
+    // Read a document that includes a library file, referencing its contents
+    // through the data library rather than importing them.
+    const std::string xmlString =
+        "<?xml version=\"1.0\"?>\n"
+        "<materialx version=\"1.39\" xmlns:xi=\"http://www.w3.org/2001/XInclude\">\n"
+        "  <xi:include href=\"libraries/stdlib/stdlib_defs.mtlx\" />\n"
+        "  <add name=\"add1\" type=\"float\" />\n"
+        "</materialx>\n";
+    mx::XmlReadOptions readOptions;
+    readOptions.skipDataLibraryXIncludes = true;
+    mx::DocumentPtr doc = mx::createDocument();
+    doc->setDataLibrary(libDoc);
+    mx::readFromXmlString(doc, xmlString, searchPath, &readOptions);
+    REQUIRE(doc->getChildren().size() == 1);
+    REQUIRE(doc->getNode("add1")->getNodeDef());
+    REQUIRE(doc->validate());
+
+    // Included files are resolved through the environment search path.
+    mx::setEnviron(mx::MATERIALX_SEARCH_PATH_ENV_VAR, searchPath.asString());
+    mx::DocumentPtr envDoc = mx::createDocument();
+    envDoc->setDataLibrary(libDoc);
+    mx::readFromXmlString(envDoc, xmlString, mx::FileSearchPath(), &readOptions);
+    mx::removeEnviron(mx::MATERIALX_SEARCH_PATH_ENV_VAR);
+    REQUIRE(envDoc->getChildren().size() == 1);
+
+    // Without a data library, the included file is imported.
+    mx::DocumentPtr importDoc = mx::createDocument();
+    mx::readFromXmlString(importDoc, xmlString, searchPath, &readOptions);
+    REQUIRE(importDoc->getChildren().size() > 1);
+    REQUIRE(importDoc->getNode("add1")->getNodeDef());
+
+    // Share the data library across documents on multiple threads.
+    std::vector<std::thread> threads;
+    std::vector<size_t> matchCounts(4);
+    for (size_t i = 0; i < matchCounts.size(); i++)
+    {
+        threads.emplace_back([&, i]()
+        {
+            for (int j = 0; j < 50; j++)
+            {
+                mx::DocumentPtr threadDoc = mx::createDocument();
+                threadDoc->setDataLibrary(libDoc);
+                mx::NodePtr node = threadDoc->addNode("multiply", "multiply1", "color3");
+                matchCounts[i] = threadDoc->getMatchingNodeDefs("multiply").size();
+                if (!node->getNodeDef() || threadDoc->getMatchingImplementations("ND_multiply_color3").empty())
+                {
+                    matchCounts[i] = 0;
+                    break;
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    for (size_t matchCount : matchCounts)
+    {
+        REQUIRE(matchCount == libDoc->getMatchingNodeDefs("multiply").size());
+    }
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+    mx::DocumentPtr unfrozenLibDoc = libDoc->copy();
+    BENCHMARK("Read document with imported library")
+    {
+        mx::DocumentPtr benchDoc = mx::createDocument();
+        benchDoc->importLibrary(unfrozenLibDoc);
+        mx::readFromXmlString(benchDoc, xmlString, searchPath);
+        return benchDoc;
+    };
+    BENCHMARK("Read document with shared library")
+    {
+        mx::DocumentPtr benchDoc = mx::createDocument();
+        benchDoc->setDataLibrary(libDoc);
+        mx::readFromXmlString(benchDoc, xmlString, searchPath, &readOptions);
+        return benchDoc;
+    };
+#endif
+}
+
 TEST_CASE("Comments and newlines", "[xmlio]")
 {
     mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
@@ -262,6 +465,301 @@ TEST_CASE("Comments and newlines", "[xmlio]")
     REQUIRE(origXml == newXml);
 }
 
+TEST_CASE("Version upgrades", "[xmlio]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::FilePath upgradePath = searchPath.find("resources/Materials/TestSuite/stdlib/upgrade");
+    const std::pair<int, int> currentVersion(MATERIALX_MAJOR_VERSION, MATERIALX_MINOR_VERSION);
+
+    // Verify that each upgrade pass is reported in order.
+    std::vector<std::pair<int, int>> upgradedVersions;
+    mx::XmlReadOptions readOptions;
+    readOptions.upgradeVersionCallback = [&upgradedVersions](int majorVersion, int minorVersion, double seconds)
+    {
+        REQUIRE(seconds >= 0.0);
+        upgradedVersions.emplace_back(majorVersion, minorVersion);
+    };
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::readFromXmlFile(doc, upgradePath / "syntax_1_22.mtlx", searchPath, &readOptions);
+    REQUIRE(doc->getVersionIntegers() == currentVersion);
+    REQUIRE(upgradedVersions.size() == 10);
+    REQUIRE(upgradedVersions.front() == std::make_pair(1, 22));
+    REQUIRE(upgradedVersions.back() == std::make_pair(1, 38));
+    REQUIRE(std::is_sorted(upgradedVersions.begin(), upgradedVersions.end()));
+
+    // Verify that current documents are not upgraded.
+    upgradedVersions.clear();
+    doc->upgradeVersion(readOptions.upgradeVersionCallback);
+    REQUIRE(upgradedVersions.empty());
+
+    // Verify that upgraded documents match regardless of the callback.
+    mx::DocumentPtr legacyDoc = mx::createDocument();
+    readOptions.upgradeVersion = false;
+    mx::readFromXmlFile(legacyDoc, upgradePath / "syntax_1_22.mtlx", searchPath, &readOptions);
+    REQUIRE(legacyDoc->getVersionIntegers() == std::make_pair(1, 22));
+    legacyDoc->upgradeVersion();
+    REQUIRE(legacyDoc->getVersionIntegers() == currentVersion);
+    REQUIRE(mx::writeToXmlString(legacyDoc) == mx::writeToXmlString(doc));
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+    std::vector<mx::DocumentPtr> legacyDocs;
+    for (const mx::FilePath& filename : upgradePath.getFilesInDirectory(mx::MTLX_EXTENSION))
+    {
+        mx::DocumentPtr legacy = mx::createDocument();
+        mx::readFromXmlFile(legacy, upgradePath / filename, searchPath, &readOptions);
+        legacyDocs.push_back(legacy);
+    }
+    BENCHMARK("Upgrade legacy documents")
+    {
+        size_t elementCount = 0;
+        for (mx::DocumentPtr legacy : legacyDocs)
+        {
+            mx::DocumentPtr upgraded = legacy->copy();
+            upgraded->upgradeVersion();
+            elementCount += upgraded->getChildren().size();
+        }
+        return elementCount;
+    };
+#endif
+}
+
+TEST_CASE("Streaming reads", "[xmlio]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::FilePath materialsPath = searchPath.find("resources/Materials");
+    mx::XmlReadOptions streamOptions;
+    streamOptions.streamingRead = true;
+
+    // Verify that streamed documents match those read through the XML DOM.
+    for (const mx::FilePath& dir : materialsPath.getSubDirectories())
+    {
+        for (const mx::FilePath& filename : dir.getFilesInDirectory(mx::MTLX_EXTENSION))
+        {
+            mx::DocumentPtr doc = mx::createDocument();
+            mx::DocumentPtr streamDoc = mx::createDocument();
+            try
+            {
+                mx::readFromXmlFile(doc, dir / filename, searchPath);
+            }
+            catch (const mx::Exception&)
+            {
+                REQUIRE_THROWS_AS(mx::readFromXmlFile(streamDoc, dir / filename, searchPath, &streamOptions), mx::Exception);
+                continue;
+            }
+            mx::readFromXmlFile(streamDoc, dir / filename, searchPath, &streamOptions);
+            REQUIRE(*streamDoc == *doc);
+        }
+    }
+
+    // Verify that comments, newlines and character references are preserved.
+    mx::FilePath testPath = searchPath.find("resources/Materials/Examples/StandardSurface/standard_surface_chess_set.mtlx");
+    std::string origXml = mx::readFile(testPath);
+    streamOptions.readComments = true;
+    streamOptions.readNewlines = true;
+    streamOptions.upgradeVersion = false;
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::readFromXmlBuffer(doc, origXml.c_str(), mx::FileSearchPath(), &streamOptions);
+    REQUIRE(mx::writeToXmlString(doc) == origXml);
+    std::string refXml = "<?xml version=\"1.0\"?>\r\n<!DOCTYPE materialx>\r\n"
+                         "<materialx version=\"1.39\">\r\n  <look name=\"a&amp;b\" doc=\"&lt;&#x41;&#66;\r\n&gt;\" />\r\n</materialx>\r\n";
+    mx::DocumentPtr refDoc = mx::createDocument();
+    mx::readFromXmlString(refDoc, refXml);
+    doc = mx::createDocument();
+    mx::readFromXmlString(doc, refXml, mx::FileSearchPath(), &streamOptions);
+    REQUIRE(doc->getLook("a&b")->getDocString() == "<AB >");
+    REQUIRE(*doc == *refDoc);
+
+    // Verify that XIncludes take precedence regardless of their position.
+    std::string includeXml = "<materialx version=\"1.39\">"
+                             "  <nodedef name=\"ND_image_color3\" node=\"custom\" />"
+                             "  <look name=\"look1\" />"
+                             "  <xi:include href=\"libraries/stdlib/stdlib_defs.mtlx\" />"
+                             "</materialx>";
+    mx::DocumentPtr includeDoc = mx::createDocument();
+    mx::readFromXmlString(includeDoc, includeXml, searchPath);
+    doc = mx::createDocument();
+    streamOptions = mx::XmlReadOptions();
+    streamOptions.streamingRead = true;
+    mx::readFromXmlString(doc, includeXml, searchPath, &streamOptions);
+    REQUIRE(doc->getNodeDef("ND_image_color3")->getNodeString() == "image");
+    REQUIRE(mx::writeToXmlString(doc) == mx::writeToXmlString(includeDoc));
+
+    // Verify that skipped subtrees are not read, in both read modes.
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+    for (bool streamingRead : { false, true })
+    {
+        mx::XmlReadOptions readOptions;
+        readOptions.streamingRead = streamingRead;
+        readOptions.elementPredicate = [](mx::ConstElementPtr elem)
+        {
+            return !elem->getParent()->isA<mx::Document>() || elem->isA<mx::NodeDef>();
+        };
+        mx::DocumentPtr defsDoc = mx::createDocument();
+        mx::loadLibraries({ "libraries" }, searchPath, defsDoc, mx::StringSet(), &readOptions);
+        REQUIRE(defsDoc->getNodeDefs().size() == libraries->getNodeDefs().size());
+        REQUIRE(defsDoc->getChildren().size() == libraries->getNodeDefs().size());
+        for (mx::NodeDefPtr nodeDef : defsDoc->getNodeDefs())
+        {
+            REQUIRE(*nodeDef == *libraries->getNodeDef(nodeDef->getName()));
+        }
+    }
+
+    // Verify that malformed documents raise parse errors.
+    for (const char* badXml : { "<materialx><look></materialx>", "<materialx>", "<look/>",
+                                       "<materialx><look name=\"a></materialx>", "<materialx><!-- </materialx>" })
+    {
+        doc = mx::createDocument();
+        REQUIRE_THROWS_AS(mx::readFromXmlString(doc, badXml, mx::FileSearchPath(), &streamOptions), mx::ExceptionParseError);
+    }
+    REQUIRE_THROWS_AS(mx::readFromXmlFile(doc, "missing.mtlx", mx::FileSearchPath(), &streamOptions), mx::ExceptionFileMissing);
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+    mx::XmlWriteOptions writeOptions;
+    writeOptions.writeXIncludeEnable = false;
+    std::string libraryXml = mx::writeToXmlString(libraries, &writeOptions);
+    for (bool streamingRead : { false, true })
+    {
+        mx::XmlReadOptions readOptions;
+        readOptions.streamingRead = streamingRead;
+        BENCHMARK(std::string("Read library string with ") + (streamingRead ? "streaming reader" : "XML DOM"))
+        {
+            mx::DocumentPtr benchDoc = mx::createDocument();
+            mx::readFromXmlString(benchDoc, libraryXml, mx::FileSearchPath(), &readOptions);
+            return benchDoc->getChildren().size();
+        };
+    }
+#endif
+}
+
+TEST_CASE("Deferred nodegraph bodies", "[xmlio]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+
+    mx::XmlReadOptions readOptions;
+    readOptions.deferNodeGraphBodies = true;
+    mx::DocumentPtr deferred = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, deferred, mx::StringSet(), &readOptions);
+    REQUIRE(deferred->getNodeGraphs().size() == libraries->getNodeGraphs().size());
+    size_t deferredCount = 0;
+    for (mx::NodeGraphPtr graph : deferred->getNodeGraphs())
+    {
+        if (graph->hasDeferredBody())
+        {
+            deferredCount++;
+        }
+    }
+    REQUIRE(deferredCount > 0);
+
+    // Verify that child queries, hashing and equivalence read deferred bodies.
+    const std::string tiledImage = "NG_tiledimage_float";
+    mx::NodeGraphPtr tiledGraph = deferred->getChildOfType<mx::NodeGraph>(tiledImage);
+    mx::NodeGraphPtr expectedGraph = libraries->getNodeGraph(tiledImage);
+    REQUIRE(tiledGraph->hasDeferredBody());
+    REQUIRE(tiledGraph->getChildren().size() == expectedGraph->getChildren().size());
+    REQUIRE(!tiledGraph->hasDeferredBody());
+    mx::NodeGraphPtr hashedGraph = deferred->getChildOfType<mx::NodeGraph>("NG_tiledimage_color3");
+    REQUIRE(hashedGraph->hasDeferredBody());
+    REQUIRE(hashedGraph->getContentHash() == libraries->getNodeGraph(hashedGraph->getName())->getContentHash());
+    mx::NodeGraphPtr equivalentGraph = deferred->getChildOfType<mx::NodeGraph>("NG_tiledimage_color4");
+    REQUIRE(equivalentGraph->hasDeferredBody());
+    REQUIRE(equivalentGraph->isEquivalent(libraries->getNodeGraph(equivalentGraph->getName()), mx::ElementEquivalenceOptions()));
+
+    // Verify that freezing a document reads its deferred bodies.
+    mx::DocumentPtr frozen = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, frozen, mx::StringSet(), &readOptions);
+    frozen->freeze();
+    for (mx::NodeGraphPtr graph : frozen->getNodeGraphs())
+    {
+        REQUIRE(!graph->hasDeferredBody());
+    }
+    REQUIRE(frozen->getNodeGraph(tiledImage)->getChildren().size() == expectedGraph->getChildren().size());
+
+    // Verify that parallel validation reads deferred bodies before its
+    // workers are started.
+    mx::DocumentPtr validated = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, validated, mx::StringSet(), &readOptions);
+    mx::ValidationOptions validationOptions;
+    validationOptions.threadCount = 4;
+    REQUIRE(validated->validate(nullptr, validationOptions));
+    for (mx::NodeGraphPtr graph : validated->getNodeGraphs())
+    {
+        REQUIRE(!graph->hasDeferredBody());
+    }
+
+    // Verify that a body that fails to load remains deferred.
+    mx::DocumentPtr failingDoc = mx::createDocument();
+    mx::NodeGraphPtr failingGraph = failingDoc->addNodeGraph();
+    bool fail = true;
+    failingGraph->setDeferredBody([&fail](mx::NodeGraphPtr target)
+    {
+        target->addNode("constant", "node1");
+        if (fail)
+        {
+            throw mx::Exception("Failed to read body");
+        }
+    });
+    REQUIRE_THROWS_AS(failingGraph->loadDeferredBody(), mx::Exception);
+    REQUIRE(failingGraph->hasDeferredBody());
+    REQUIRE_THROWS_AS(failingGraph->getChildren(), mx::Exception);
+    fail = false;
+    REQUIRE(failingGraph->getChildren().size() == 1);
+    REQUIRE(!failingGraph->hasDeferredBody());
+
+    // Verify that copies carry deferred bodies, which are read independently.
+    mx::DocumentPtr deferredCopy = deferred->copy();
+    mx::NodeGraphPtr sourceGraph;
+    for (mx::NodeGraphPtr graph : deferred->getNodeGraphs())
+    {
+        if (graph->hasDeferredBody())
+        {
+            sourceGraph = graph;
+            break;
+        }
+    }
+    REQUIRE(sourceGraph);
+    mx::NodeGraphPtr copiedGraph = deferredCopy->getChildOfType<mx::NodeGraph>(sourceGraph->getName());
+    REQUIRE(copiedGraph->hasDeferredBody() == sourceGraph->hasDeferredBody());
+    REQUIRE(deferredCopy->getNodeGraph(copiedGraph->getName()) == copiedGraph);
+    REQUIRE(!copiedGraph->hasDeferredBody());
+    REQUIRE(*copiedGraph == *libraries->getNodeGraph(copiedGraph->getName()));
+    REQUIRE(sourceGraph->hasDeferredBody());
+
+    // Verify that implementations are read on first access.
+    for (mx::NodeDefPtr nodeDef : deferred->getNodeDefs())
+    {
+        mx::InterfaceElementPtr impl = nodeDef->getImplementation();
+        mx::InterfaceElementPtr expected = libraries->getNodeDef(nodeDef->getName())->getImplementation();
+        REQUIRE((impl != nullptr) == (expected != nullptr));
+        if (impl && impl->isA<mx::NodeGraph>())
+        {
+            REQUIRE(!impl->asA<mx::NodeGraph>()->hasDeferredBody());
+            REQUIRE(*impl == *expected);
+        }
+    }
+
+    // Verify that validation and serialization read any remaining bodies.
+    REQUIRE(deferredCopy->validate());
+    REQUIRE(mx::writeToXmlString(deferred) == mx::writeToXmlString(libraries));
+    REQUIRE(*deferred == *libraries);
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+    for (bool deferBodies : { false, true })
+    {
+        mx::XmlReadOptions benchOptions;
+        benchOptions.deferNodeGraphBodies = deferBodies;
+        BENCHMARK(std::string("Load libraries ") + (deferBodies ? "with" : "without") + " deferred graph bodies")
+        {
+            mx::DocumentPtr benchDoc = mx::createDocument();
+            mx::loadLibraries({ "libraries" }, searchPath, benchDoc, mx::StringSet(), &benchOptions);
+            return benchDoc->getChildren().size();
+        };
+    }
+#endif
+}
+
 TEST_CASE("Maximum tree depth", "[xmlio]")
 {
     // Create a document that exceeds the maximum tree depth.
@@ -12,6 +12,8 @@
 #include <MaterialXFormat/Util.h>
 
 #include <MaterialXGenShader/HwShaderGenerator.h>
+#include <MaterialXGenShader/ShaderCache.h>
+#include <MaterialXGenShader/SourceFile.h>
 #include <MaterialXGenShader/ShaderTranslator.h>
 #include <MaterialXGenShader/Util.h>
 
@@ -28,10 +30,14 @@
 #include <MaterialXGenMsl/MslShaderGenerator.h>
 #endif
 
+#include <cstdio>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <vector>
 #include <set>
+#include <sstream>
+#include <thread>
 
 namespace mx = MaterialX;
 
@@ -425,3 +431,459 @@ TEST_CASE("GenShader: Track Application Variables", "[genshader]")
     }
 #endif
 }
+
+TEST_CASE("GenShader: Graph Optimization", "[genshader]")
+{
+    const mx::string testDocumentString =
+    "<?xml version=\"1.0\"?> \
+    <materialx version=\"1.39\"> \
+      <image name=\"image1\" type=\"color3\"> \
+        <input name=\"file\" type=\"filename\" value=\"resources/Images/grid.png\" /> \
+      </image> \
+      <image name=\"image2\" type=\"color3\"> \
+        <input name=\"file\" type=\"filename\" value=\"resources/Images/grid.png\" /> \
+      </image> \
+      <add name=\"add1\" type=\"color3\"> \
+        <input name=\"in1\" type=\"color3\" nodename=\"image1\" /> \
+        <input name=\"in2\" type=\"color3\" nodename=\"image2\" /> \
+      </add> \
+      <multiply name=\"multiply1\" type=\"float\"> \
+        <input name=\"in1\" type=\"float\" value=\"0.25\" /> \
+        <input name=\"in2\" type=\"float\" value=\"2.0\" /> \
+      </multiply> \
+      <add name=\"add2\" type=\"float\"> \
+        <input name=\"in1\" type=\"float\" nodename=\"multiply1\" /> \
+        <input name=\"in2\" type=\"float\" value=\"0.25\" /> \
+      </add> \
+      <divide name=\"divide1\" type=\"float\"> \
+        <input name=\"in1\" type=\"float\" value=\"1.0\" /> \
+        <input name=\"in2\" type=\"float\" value=\"0.0\" /> \
+      </divide> \
+      <nodedef name=\"ND_myadd_float\" node=\"multiply\"> \
+        <input name=\"in1\" type=\"float\" value=\"0.0\" /> \
+        <input name=\"in2\" type=\"float\" value=\"0.0\" /> \
+        <output name=\"out\" type=\"float\" /> \
+      </nodedef> \
+      <nodegraph name=\"NG_myadd_float\" nodedef=\"ND_myadd_float\"> \
+        <add name=\"add1\" type=\"float\"> \
+          <input name=\"in1\" type=\"float\" interfacename=\"in1\" /> \
+          <input name=\"in2\" type=\"float\" interfacename=\"in2\" /> \
+        </add> \
+        <output name=\"out\" type=\"float\" nodename=\"add1\" /> \
+      </nodegraph> \
+      <multiply name=\"myadd1\" type=\"float\" nodedef=\"ND_myadd_float\"> \
+        <input name=\"in1\" type=\"float\" value=\"2.0\" /> \
+        <input name=\"in2\" type=\"float\" value=\"3.0\" /> \
+      </multiply> \
+      <standard_surface name=\"surface\" type=\"surfaceshader\"> \
+        <input name=\"base_color\" type=\"color3\" nodename=\"add1\" /> \
+        <input name=\"specular_roughness\" type=\"float\" nodename=\"add2\" /> \
+        <input name=\"metalness\" type=\"float\" nodename=\"divide1\" /> \
+        <input name=\"coat\" type=\"float\" nodename=\"myadd1\" /> \
+      </standard_surface> \
+      <surfacematerial name=\"material\" type=\"material\"> \
+        <input name=\"surfaceshader\" type=\"surfaceshader\" nodename=\"surface\" /> \
+      </surfacematerial> \
+    </materialx>";
+
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::readFromXmlString(doc, testDocumentString);
+    doc->setDataLibrary(libraries);
+    mx::ElementPtr element = doc->getChild("material");
+    REQUIRE(element);
+
+#ifdef MATERIALX_BUILD_GEN_GLSL
+    auto countSamplers = [](const mx::Shader& shader)
+    {
+        const mx::VariableBlock& uniforms = shader.getStage(mx::Stage::PIXEL).getUniformBlock(mx::HW::PUBLIC_UNIFORMS);
+        size_t count = 0;
+        for (size_t i = 0; i < uniforms.size(); i++)
+        {
+            if (uniforms[i]->getType() == mx::Type::FILENAME)
+            {
+                count++;
+            }
+        }
+        return count;
+    };
+
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+    mx::ShaderPtr shader = context.getShaderGenerator().generate("material", element, context);
+    REQUIRE(shader);
+    REQUIRE(countSamplers(*shader) == 2);
+    REQUIRE(shader->getGraph().getNode("multiply1"));
+
+    // Constant math nodes are folded, and identical image nodes are merged.
+    context.getOptions().optimizeShaderGraph = true;
+    mx::ShaderPtr optimized = context.getShaderGenerator().generate("material", element, context);
+    REQUIRE(optimized);
+    REQUIRE(countSamplers(*optimized) == 1);
+    const mx::ShaderGraph& graph = optimized->getGraph();
+    REQUIRE(graph.getNode("image1"));
+    REQUIRE(!graph.getNode("image2"));
+    REQUIRE(!graph.getNode("multiply1"));
+    REQUIRE(!graph.getNode("add2"));
+    const mx::ShaderOutput* roughness = graph.getNode("surface")->getInput("specular_roughness")->getConnection();
+    REQUIRE(roughness->getNode() == &graph);
+    REQUIRE(roughness->getValue()->asA<float>() == Approx(0.75f));
+
+    // Nodes with undefined results are left in place.
+    REQUIRE(graph.getNode("divide1"));
+
+    // Custom nodedefs that reuse standard node strings are not folded.
+    const mx::ShaderOutput* coat = graph.getNode("surface")->getInput("coat")->getConnection();
+    REQUIRE(coat);
+    REQUIRE(coat->getNode()->getName() == "myadd1");
+    REQUIRE(optimized->getSourceCode(mx::Stage::PIXEL).size() < shader->getSourceCode(mx::Stage::PIXEL).size());
+#endif
+}
+
+TEST_CASE("GenShader: Source File Cache", "[genshader]")
+{
+#ifdef MATERIALX_BUILD_GEN_GLSL
+    mx::FilePath sourcePath = mx::FilePath::getCurrentPath() / "source_file_cache";
+    sourcePath.createDirectory();
+    mx::FilePath sourceFile = sourcePath / "source_file_cache.glsl";
+    std::ofstream(sourceFile.asString()) << "float a;\n#include \"include_a.glsl\"\nfloat b;\nfloat c;\n#include \"\"\n";
+
+    // Files are split into segments at include directives.
+    mx::ShaderGeneratorPtr generator = mx::GlslShaderGenerator::create();
+    const mx::Syntax& syntax = generator->getSyntax();
+    mx::ConstSourceFilePtr file = mx::getSourceFile(sourceFile, syntax);
+    REQUIRE(file);
+    const std::vector<mx::SourceFile::Segment>& segments = file->getSegments();
+    REQUIRE(segments.size() == 2);
+    REQUIRE(segments[0].lines == mx::StringVec{ "float a;" });
+    REQUIRE(segments[0].include == "include_a.glsl");
+    REQUIRE(segments[1].lines == mx::StringVec{ "float b;", "float c;" });
+    REQUIRE(segments[1].text == "float b;\nfloat c;\n");
+    REQUIRE(segments[1].include.empty());
+
+    // Files are cached until they are modified.
+    REQUIRE(mx::getSourceFile(sourcePath / "." / "source_file_cache.glsl", syntax) == file);
+    std::ofstream(sourceFile.asString()) << "float d;\n";
+    mx::ConstSourceFilePtr modifiedFile = mx::getSourceFile(sourceFile, syntax);
+    REQUIRE(modifiedFile != file);
+    REQUIRE(modifiedFile->getContent() == "float d;\n");
+    REQUIRE(!mx::getSourceFile(sourcePath / "missing.glsl", syntax));
+
+    // Modification stamps may be queried through a file search cache.
+    mx::FileSearchCachePtr searchCache = mx::FileSearchCache::create();
+    REQUIRE(mx::getSourceFile(sourceFile, syntax, searchCache.get()) == modifiedFile);
+    REQUIRE(mx::getSourceFile(sourceFile, syntax, searchCache.get()) == modifiedFile);
+    REQUIRE(searchCache->getStatistics().hits == 1);
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+    mx::FilePath includeFile = mx::getDefaultDataSearchPath().find("libraries/pbrlib/genglsl/lib/mx_microfacet_specular.glsl");
+    BENCHMARK("Read and split include file")
+    {
+        std::istringstream stream(mx::readFile(includeFile));
+        size_t count = 0;
+        for (std::string line; std::getline(stream, line);)
+        {
+            count += line.size();
+        }
+        return count;
+    };
+    BENCHMARK("Get cached include file")
+    {
+        return mx::getSourceFile(includeFile, syntax);
+    };
+#endif
+#endif
+}
+
+TEST_CASE("GenShader: Shader Cache", "[genshader]")
+{
+#ifdef MATERIALX_BUILD_GEN_GLSL
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::readFromXmlFile(doc, "resources/Materials/Examples/StandardSurface/standard_surface_carpaint.mtlx", searchPath);
+    doc->setDataLibrary(libraries);
+    mx::ElementPtr material = doc->getChild("Car_Paint");
+    REQUIRE(material);
+
+    mx::FilePath storePath = mx::FilePath::getCurrentPath() / "shadercache";
+    for (const mx::FilePath& file : storePath.getFilesInDirectory("mxshader"))
+    {
+        std::remove((storePath / file).asString().c_str());
+    }
+
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+    mx::ShaderPtr reference = context.getShaderGenerator().generate("Car_Paint", material, context);
+
+    // Repeated requests are served from memory.
+    mx::ShaderCachePtr cache = mx::ShaderCache::create(storePath);
+    mx::ShaderPtr shader = cache->generate("Car_Paint", material, context);
+    REQUIRE(shader);
+    REQUIRE(cache->generate("Car_Paint", material, context) == shader);
+    REQUIRE(shader->getSourceCode(mx::Stage::PIXEL) == reference->getSourceCode(mx::Stage::PIXEL));
+    mx::ShaderCacheStatistics stats = cache->getStatistics();
+    REQUIRE(stats.misses == 1);
+    REQUIRE(stats.memoryHits == 1);
+
+    // Changes to options and to upstream content produce new shaders.
+    context.getOptions().hwTransparency = true;
+    REQUIRE(cache->generate("Car_Paint", material, context) != shader);
+    context.getOptions().hwTransparency = false;
+    mx::NodePtr shaderNode = doc->getNode("SR_carpaint");
+    REQUIRE(shaderNode);
+    size_t key = cache->computeKey("Car_Paint", material, context);
+    shaderNode->setInputValue("base", 0.125f);
+    REQUIRE(cache->computeKey("Car_Paint", material, context) != key);
+    REQUIRE(cache->generate("Car_Paint", material, context) != shader);
+    REQUIRE(cache->getStatistics().misses == 3);
+
+    // Shaders are shared through the on-disk store.
+    doc = mx::createDocument();
+    mx::readFromXmlFile(doc, "resources/Materials/Examples/StandardSurface/standard_surface_carpaint.mtlx", searchPath);
+    doc->setDataLibrary(libraries);
+    material = doc->getChild("Car_Paint");
+    mx::ShaderCachePtr storeCache = mx::ShaderCache::create(storePath);
+    mx::ShaderPtr storedShader = storeCache->generate("Car_Paint", material, context);
+    REQUIRE(storeCache->getStatistics().diskHits == 1);
+    REQUIRE(storedShader->numStages() == reference->numStages());
+    for (size_t i = 0; i < reference->numStages(); i++)
+    {
+        const mx::ShaderStage& refStage = reference->getStage(i);
+        const mx::ShaderStage& stage = storedShader->getStage(refStage.getName());
+        REQUIRE(stage.getSourceCode() == refStage.getSourceCode());
+        REQUIRE(stage.getFunctionName() == refStage.getFunctionName());
+        REQUIRE(stage.getSourceDependencies() == refStage.getSourceDependencies());
+        REQUIRE(stage.getUniformBlocks().size() == refStage.getUniformBlocks().size());
+        for (const auto& pair : refStage.getUniformBlocks())
+        {
+            const mx::VariableBlock& refBlock = *pair.second;
+            const mx::VariableBlock& block = stage.getUniformBlock(pair.first);
+            REQUIRE(block.size() == refBlock.size());
+            for (size_t j = 0; j < refBlock.size(); j++)
+            {
+                REQUIRE(block[j]->getVariable() == refBlock[j]->getVariable());
+                REQUIRE(block[j]->getType() == refBlock[j]->getType());
+                REQUIRE(block[j]->getPath() == refBlock[j]->getPath());
+                if (refBlock[j]->getValue())
+                {
+                    REQUIRE(block[j]->getValue()->getValueString() == refBlock[j]->getValue()->getValueString());
+                }
+            }
+        }
+    }
+    REQUIRE(storedShader->hasAttribute(mx::HW::ATTR_TRANSPARENT) == reference->hasAttribute(mx::HW::ATTR_TRANSPARENT));
+
+    // Shaders are regenerated when their source files change.
+    mx::FilePath sourceFile = storePath / "cache_test.glsl";
+    std::ofstream(sourceFile.asString()) << "void cache_test(out vec3 result) { result = vec3(0.25); }\n";
+    mx::DocumentPtr sourceDoc = mx::createDocument();
+    sourceDoc->setDataLibrary(libraries);
+    mx::NodeDefPtr nodeDef = sourceDoc->addNodeDef("ND_cache_test", "color3", "cache_test");
+    mx::ImplementationPtr impl = sourceDoc->addImplementation("IM_cache_test");
+    impl->setNodeDef(nodeDef);
+    impl->setFile(sourceFile);
+    impl->setFunction("cache_test");
+    impl->setTarget(mx::GlslShaderGenerator::TARGET);
+    mx::NodePtr sourceNode = sourceDoc->addNode("cache_test", "cache_test1", "color3");
+    mx::ShaderCachePtr sourceCache = mx::ShaderCache::create();
+    mx::ShaderPtr sourceShader = sourceCache->generate("cache_test1", sourceNode, context);
+    REQUIRE(sourceCache->generate("cache_test1", sourceNode, context) == sourceShader);
+    std::ofstream(sourceFile.asString()) << "void cache_test(out vec3 result) { result = vec3(0.5); }\n";
+    mx::GenContext sourceContext(mx::GlslShaderGenerator::create());
+    sourceContext.registerSourceCodeSearchPath(searchPath);
+    mx::ShaderPtr updatedShader = sourceCache->generate("cache_test1", sourceNode, sourceContext);
+    REQUIRE(updatedShader != sourceShader);
+    REQUIRE(updatedShader->getSourceCode().find("vec3(0.5)") != std::string::npos);
+    stats = sourceCache->getStatistics();
+    REQUIRE(stats.invalidations == 1);
+    REQUIRE(stats.misses == 2);
+    REQUIRE(stats.memoryHits == 1);
+
+    // Memoized definition graph keys do not keep graphs or documents alive.
+    mx::DocumentPtr graphDoc = mx::createDocument();
+    graphDoc->setDataLibrary(libraries);
+    mx::NodeDefPtr graphDef = graphDoc->addNodeDef("ND_cache_graph", "float", "cache_graph");
+    mx::NodeGraphPtr graph = graphDoc->addNodeGraph("NG_cache_graph");
+    graph->setNodeDef(graphDef);
+    mx::NodePtr multiply = graph->addNode("multiply", "multiply1", "float");
+    multiply->setInputValue("in1", 0.25f);
+    multiply->setInputValue("in2", 2.0f);
+    graph->addOutput("out", "float")->setConnectedNode(multiply);
+    mx::NodePtr graphNode = graphDoc->addNode("cache_graph", "cache_graph1", "float");
+    mx::ShaderCachePtr graphCache = mx::ShaderCache::create();
+    size_t graphKey = graphCache->computeKey("cache_graph1", graphNode, context);
+    REQUIRE(graphCache->computeKey("cache_graph1", graphNode, context) == graphKey);
+    std::weak_ptr<mx::NodeGraph> weakGraph = graph;
+    std::weak_ptr<mx::Document> weakGraphDoc = graphDoc;
+    graphDef = nullptr;
+    graph = nullptr;
+    multiply = nullptr;
+    graphNode = nullptr;
+    graphDoc = nullptr;
+    REQUIRE(weakGraph.expired());
+    REQUIRE(weakGraphDoc.expired());
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+    BENCHMARK("Generate shader")
+    {
+        return context.getShaderGenerator().generate("Car_Paint", material, context);
+    };
+    BENCHMARK("Generate shader through cache")
+    {
+        return storeCache->generate("Car_Paint", material, context);
+    };
+#endif
+#endif
+}
+
+TEST_CASE("GenShader: Shared Node Implementations", "[genshader]")
+{
+#ifdef MATERIALX_BUILD_GEN_GLSL
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::readFromXmlFile(doc, "resources/Materials/Examples/StandardSurface/standard_surface_carpaint.mtlx", searchPath);
+    doc->setDataLibrary(libraries);
+    mx::ElementPtr material = doc->getChild("Car_Paint");
+    REQUIRE(material);
+
+    mx::GenContext referenceContext(mx::GlslShaderGenerator::create());
+    referenceContext.registerSourceCodeSearchPath(searchPath);
+    const std::string reference = referenceContext.getShaderGenerator().generate("Car_Paint", material, referenceContext)->getSourceCode();
+
+    // Generate from multiple threads, each with its own context.
+    mx::ShaderNodeImplRegistryPtr registry = mx::ShaderNodeImplRegistry::create();
+    const size_t threadCount = 4;
+    std::vector<std::unique_ptr<mx::GenContext>> contexts;
+    std::vector<std::string> results(threadCount);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < threadCount; i++)
+    {
+        contexts.emplace_back(new mx::GenContext(mx::GlslShaderGenerator::create()));
+        contexts.back()->registerSourceCodeSearchPath(searchPath);
+        contexts.back()->setNodeImplRegistry(registry);
+    }
+    for (size_t i = 0; i < threadCount; i++)
+    {
+        threads.emplace_back([&, i]()
+        {
+            mx::GenContext& context = *contexts[i];
+            results[i] = context.getShaderGenerator().generate("Car_Paint", material, context)->getSourceCode();
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    for (const std::string& result : results)
+    {
+        REQUIRE(result == reference);
+    }
+
+    // Implementations are shared between contexts.
+    const size_t registrySize = registry->size();
+    REQUIRE(registrySize > 0);
+    mx::StringSet implNames;
+    contexts[0]->getNodeImplementationNames(implNames);
+    size_t sharedCount = 0;
+    for (const std::string& implName : implNames)
+    {
+        mx::ShaderNodeImplPtr impl = contexts[1]->findNodeImplementation(implName);
+        if (impl)
+        {
+            REQUIRE(impl == contexts[0]->findNodeImplementation(implName));
+            sharedCount++;
+        }
+    }
+    REQUIRE(sharedCount > 0);
+
+    // Contexts with differing options do not share implementations.
+    mx::GenContext flippedContext(mx::GlslShaderGenerator::create());
+    flippedContext.registerSourceCodeSearchPath(searchPath);
+    flippedContext.getOptions().fileTextureVerticalFlip = true;
+    flippedContext.setNodeImplRegistry(registry);
+    REQUIRE(flippedContext.getConfigurationHash() != contexts[0]->getConfigurationHash());
+    flippedContext.getShaderGenerator().generate("Car_Paint", material, flippedContext);
+    REQUIRE(registry->size() == 2 * registrySize);
+
+    // Contexts share implementations from identical data libraries, but not
+    // from libraries whose implementation elements differ.
+    mx::DocumentPtr editedLibraries = libraries->copy();
+    mx::DocumentPtr editedDoc = doc->copy();
+    editedDoc->setDataLibrary(editedLibraries);
+    mx::GenContext copiedContext(mx::GlslShaderGenerator::create());
+    copiedContext.registerSourceCodeSearchPath(searchPath);
+    copiedContext.setNodeImplRegistry(registry);
+    copiedContext.getShaderGenerator().generate("Car_Paint", editedDoc->getChild("Car_Paint"), copiedContext);
+    REQUIRE(registry->size() == 2 * registrySize);
+    mx::NodeGraphPtr surfaceGraph = editedLibraries->getNodeGraph("NG_standard_surface_surfaceshader_100");
+    REQUIRE(surfaceGraph);
+    surfaceGraph->setDocString("Edited implementation");
+    mx::GenContext editedContext(mx::GlslShaderGenerator::create());
+    editedContext.registerSourceCodeSearchPath(searchPath);
+    editedContext.setNodeImplRegistry(registry);
+    editedContext.getShaderGenerator().generate("Car_Paint", editedDoc->getChild("Car_Paint"), editedContext);
+    REQUIRE(registry->size() == 2 * registrySize + 1);
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+    BENCHMARK("Generate shader in new context")
+    {
+        mx::GenContext context(mx::GlslShaderGenerator::create());
+        context.registerSourceCodeSearchPath(searchPath);
+        return context.getShaderGenerator().generate("Car_Paint", material, context);
+    };
+    BENCHMARK("Generate shader in new context with shared implementations")
+    {
+        mx::GenContext context(mx::GlslShaderGenerator::create());
+        context.registerSourceCodeSearchPath(searchPath);
+        context.setNodeImplRegistry(registry);
+        return context.getShaderGenerator().generate("Car_Paint", material, context);
+    };
+
+    // Measure the throughput of a fixed number of generations, divided among
+    // threads that each create their own contexts.
+    auto generateConcurrently = [&](size_t threadCount, mx::ShaderNodeImplRegistryPtr sharedRegistry)
+    {
+        const size_t generationCount = 16;
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < threadCount; i++)
+        {
+            workers.emplace_back([&, i]()
+            {
+                for (size_t j = i; j < generationCount; j += threadCount)
+                {
+                    mx::GenContext context(mx::GlslShaderGenerator::create());
+                    context.registerSourceCodeSearchPath(searchPath);
+                    context.setNodeImplRegistry(sharedRegistry);
+                    context.getShaderGenerator().generate("Car_Paint", material, context);
+                }
+            });
+        }
+        for (std::thread& worker : workers)
+        {
+            worker.join();
+        }
+        return generationCount;
+    };
+    for (size_t threadCount : { 1, 2, 4, 8 })
+    {
+        BENCHMARK("Generate 16 shaders with " + std::to_string(threadCount) + " threads")
+        {
+            return generateConcurrently(threadCount, nullptr);
+        };
+        BENCHMARK("Generate 16 shaders with " + std::to_string(threadCount) + " threads and shared implementations")
+        {
+            return generateConcurrently(threadCount, registry);
+        };
+    }
+#endif
+#endif
+}
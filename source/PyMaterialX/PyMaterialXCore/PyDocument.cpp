@@ -32,6 +32,8 @@ void bindPyDocument(py::module& mod)
         .def("setDataLibrary", &mx::Document::setDataLibrary)
         .def("getDataLibrary", &mx::Document::getDataLibrary)
         .def("hasDataLibrary", &mx::Document::hasDataLibrary)
+        .def("freeze", &mx::Document::freeze)
+        .def("isFrozen", &mx::Document::isFrozen)
         .def("importLibrary", &mx::Document::importLibrary)
         .def("getReferencedSourceUris", &mx::Document::getReferencedSourceUris)
         .def("addNodeGraph", &mx::Document::addNodeGraph,
@@ -113,11 +115,24 @@ void bindPyDocument(py::module& mod)
         .def("getUnitTypeDef", &mx::Document::getUnitTypeDef)
         .def("getUnitTypeDefs", &mx::Document::getUnitTypeDefs)
         .def("removeUnitTypeDef", &mx::Document::removeUnitTypeDef)
-        .def("upgradeVersion", &mx::Document::upgradeVersion)
+        .def("upgradeVersion", &mx::Document::upgradeVersion,
+            py::arg("callback") = nullptr)
+        .def("validate", [](const mx::Document& doc, const mx::ValidationOptions& options)
+            {
+                std::string message;
+                bool res = doc.validate(&message, options);
+                return std::pair<bool, std::string>(res, message);
+            },
+            py::arg("options") = mx::ValidationOptions())
         .def("setColorManagementSystem", &mx::Document::setColorManagementSystem)
         .def("hasColorManagementSystem", &mx::Document::hasColorManagementSystem)
         .def("getColorManagementSystem", &mx::Document::getColorManagementSystem)
         .def("setColorManagementConfig", &mx::Document::setColorManagementConfig)
         .def("hasColorManagementConfig", &mx::Document::hasColorManagementConfig)
-        .def("getColorManagementConfig", &mx::Document::getColorManagementConfig);
+        .def("getColorManagementConfig", &mx::Document::getColorManagementConfig)
+        .def("invalidateCache", &mx::Document::invalidateCache)
+        .def("setValueCaching", &mx::Document::setValueCaching)
+        .def("getValueCaching", &mx::Document::getValueCaching)
+        .def("setElementPooling", &mx::Document::setElementPooling)
+        .def("getElementPooling", &mx::Document::getElementPooling);
 }
@@ -35,6 +35,8 @@ void bindPyElement(py::module& mod)
             bool res = elem.isEquivalent(rhs, options, &message);
             return std::pair<bool, std::string>(res, message);
         })        
+        .def("getContentHash", &mx::Element::getContentHash)
+        .def("diff", &mx::Element::diff)
         .def("setCategory", &mx::Element::setCategory)
         .def("getCategory", &mx::Element::getCategory)
         .def("setName", &mx::Element::setName)
@@ -157,6 +159,12 @@ void bindPyElement(py::module& mod)
         .def("hasImplementationName", &mx::ValueElement::hasImplementationName)
         .def("getImplementationName", &mx::ValueElement::getImplementationName)
         .def("_getValue", &mx::ValueElement::getValue)
+        .def("getConstValue", [](const mx::ValueElement& elem)
+            {
+                // Values are immutable from Python, so the cached value
+                // may be shared without a copy.
+                return std::const_pointer_cast<mx::Value>(elem.getConstValue());
+            })
         .def("_getDefaultValue", &mx::ValueElement::getDefaultValue)
         .def("setUnit", &mx::ValueElement::setUnit)
         .def("hasUnit", &mx::ValueElement::hasUnit)
@@ -218,6 +226,11 @@ void bindPyElement(py::module& mod)
         .def_readwrite("attributeExclusionList", &mx::ElementEquivalenceOptions::attributeExclusionList)
         .def(py::init<>());
 
+    py::class_<mx::ValidationOptions>(mod, "ValidationOptions")
+        .def_readwrite("threadCount", &mx::ValidationOptions::threadCount)
+        .def_readwrite("firstErrorOnly", &mx::ValidationOptions::firstErrorOnly)
+        .def(py::init<>());
+
     py::class_<mx::StringResolver, mx::StringResolverPtr>(mod, "StringResolver")
         .def("setFilePrefix", &mx::StringResolver::setFilePrefix)
         .def("getFilePrefix", &mx::StringResolver::getFilePrefix)
@@ -5,6 +5,7 @@
 
 #include <PyMaterialX/PyMaterialX.h>
 
+#include <MaterialXCore/Document.h>
 #include <MaterialXCore/Look.h>
 
 namespace py = pybind11;
@@ -83,4 +84,12 @@ void bindPyLook(py::module& mod)
 
     mod.def("getGeometryBindings", &mx::getGeometryBindings,
         py::arg("materialNode") , py::arg("geom") = mx::UNIVERSAL_GEOM_NAME);
+
+    py::class_<mx::GeometryBindingResolver>(mod, "GeometryBindingResolver")
+        .def(py::init<mx::ConstDocumentPtr>())
+        .def("getBindings", &mx::GeometryBindingResolver::getBindings,
+            py::arg("geom"), py::arg("materialNode") = nullptr)
+        .def("getBatchBindings", &mx::GeometryBindingResolver::getBatchBindings,
+            py::arg("geoms"), py::arg("materialNode") = nullptr)
+        .def("getAssignCount", &mx::GeometryBindingResolver::getAssignCount);
 }
@@ -59,6 +59,8 @@ void bindPyNode(py::module& mod)
         .def("addInterfaceName", &mx::NodeGraph::addInterfaceName)
         .def("removeInterfaceName", &mx::NodeGraph::removeInterfaceName)
         .def("modifyInterfaceName", &mx::NodeGraph::modifyInterfaceName)
+        .def("hasDeferredBody", &mx::NodeGraph::hasDeferredBody)
+        .def("loadDeferredBody", &mx::NodeGraph::loadDeferredBody)
         .def("getDownstreamPorts", &mx::NodeGraph::getDownstreamPorts)
         .def_readonly_static("CATEGORY", &mx::NodeGraph::CATEGORY);
 
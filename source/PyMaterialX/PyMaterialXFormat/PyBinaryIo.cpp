@@ -0,0 +1,32 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <PyMaterialX/PyMaterialX.h>
+
+#include <MaterialXFormat/BinaryIo.h>
+#include <MaterialXCore/Document.h>
+
+namespace py = pybind11;
+namespace mx = MaterialX;
+
+void bindPyBinaryIo(py::module& mod)
+{
+    mod.def("readFromBinaryFile", &mx::readFromBinaryFile,
+        py::arg("doc"), py::arg("filename"), py::arg("searchPath") = mx::FileSearchPath());
+    mod.def("readFromBinaryBuffer", [](mx::DocumentPtr doc, const py::bytes& buffer)
+    {
+        std::string_view view(buffer);
+        mx::readFromBinaryBuffer(doc, view.data(), view.size());
+    }, py::arg("doc"), py::arg("buffer"));
+    mod.def("writeToBinaryFile", &mx::writeToBinaryFile,
+        py::arg("doc"), py::arg("filename"));
+    mod.def("writeToBinaryBuffer", [](mx::DocumentPtr doc)
+    {
+        return py::bytes(mx::writeToBinaryString(doc));
+    }, py::arg("doc"));
+
+    mod.attr("MTLX_BINARY_EXTENSION") = mx::MTLX_BINARY_EXTENSION;
+    mod.attr("MTLX_BINARY_FORMAT_VERSION") = mx::MTLX_BINARY_FORMAT_VERSION;
+}
@@ -43,6 +43,7 @@ void bindPyFile(py::module& mod)
         .def("getNormalized", &mx::FilePath::getNormalized)        
         .def("exists", &mx::FilePath::exists)
         .def("isDirectory", &mx::FilePath::isDirectory)
+        .def("getModificationStamp", &mx::FilePath::getModificationStamp)
         .def("getFilesInDirectory", &mx::FilePath::getFilesInDirectory)
         .def("getSubDirectories", &mx::FilePath::getSubDirectories)
         .def("createDirectory", &mx::FilePath::createDirectory)
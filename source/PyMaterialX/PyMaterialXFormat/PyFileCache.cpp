@@ -0,0 +1,37 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <PyMaterialX/PyMaterialX.h>
+
+#include <MaterialXFormat/FileCache.h>
+
+namespace py = pybind11;
+namespace mx = MaterialX;
+
+void bindPyFileCache(py::module& mod)
+{
+    py::class_<mx::FileSearchCacheStatistics>(mod, "FileSearchCacheStatistics")
+        .def(py::init<>())
+        .def_readwrite("hits", &mx::FileSearchCacheStatistics::hits)
+        .def_readwrite("misses", &mx::FileSearchCacheStatistics::misses)
+        .def_readwrite("syscalls", &mx::FileSearchCacheStatistics::syscalls)
+        .def_readwrite("syscallsAvoided", &mx::FileSearchCacheStatistics::syscallsAvoided);
+
+    py::class_<mx::FileSearchCache, mx::FileSearchCachePtr>(mod, "FileSearchCache")
+        .def_static("create", &mx::FileSearchCache::create, py::arg("directorySnapshots") = false)
+        .def(py::init<bool>(), py::arg("directorySnapshots") = false)
+        .def("exists", &mx::FileSearchCache::exists)
+        .def("getModificationStamp", &mx::FileSearchCache::getModificationStamp)
+        .def("find", &mx::FileSearchCache::find,
+             py::arg("filename"), py::arg("searchPath"), py::arg("localPath") = mx::FilePath())
+        .def("getFilesInDirectory", &mx::FileSearchCache::getFilesInDirectory)
+        .def("getSubDirectories", &mx::FileSearchCache::getSubDirectories)
+        .def("setDirectorySnapshots", &mx::FileSearchCache::setDirectorySnapshots)
+        .def("getDirectorySnapshots", &mx::FileSearchCache::getDirectorySnapshots)
+        .def("invalidate", static_cast<void (mx::FileSearchCache::*)()>(&mx::FileSearchCache::invalidate))
+        .def("invalidate", static_cast<void (mx::FileSearchCache::*)(const mx::FilePath&)>(&mx::FileSearchCache::invalidate))
+        .def("getStatistics", &mx::FileSearchCache::getStatistics)
+        .def("resetStatistics", &mx::FileSearchCache::resetStatistics);
+}
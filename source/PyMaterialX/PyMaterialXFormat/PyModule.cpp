@@ -8,7 +8,9 @@
 namespace py = pybind11;
 
 void bindPyFile(py::module& mod);
+void bindPyFileCache(py::module& mod);
 void bindPyXmlIo(py::module& mod);
+void bindPyBinaryIo(py::module& mod);
 void bindPyUtil(py::module& mod);
 
 PYBIND11_MODULE(PyMaterialXFormat, mod)
@@ -19,6 +21,8 @@ PYBIND11_MODULE(PyMaterialXFormat, mod)
     PYMATERIALX_IMPORT_MODULE(PyMaterialXCore);
 
     bindPyFile(mod);
+    bindPyFileCache(mod);
     bindPyXmlIo(mod);
+    bindPyBinaryIo(mod);
     bindPyUtil(mod);
 }
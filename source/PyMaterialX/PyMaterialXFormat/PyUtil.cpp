@@ -14,6 +14,16 @@ namespace mx = MaterialX;
 
 void bindPyUtil(py::module& mod)
 {
+    py::class_<mx::LibraryLoadOptions>(mod, "LibraryLoadOptions")
+        .def(py::init())
+        .def_readwrite("threadCount", &mx::LibraryLoadOptions::threadCount);
+
+    py::class_<mx::LibraryLoadStatistics>(mod, "LibraryLoadStatistics")
+        .def(py::init())
+        .def_readwrite("fileCount", &mx::LibraryLoadStatistics::fileCount)
+        .def_readwrite("readTime", &mx::LibraryLoadStatistics::readTime)
+        .def_readwrite("importTime", &mx::LibraryLoadStatistics::importTime);
+
     mod.def("readFile", &mx::readFile);
     mod.def("getSubdirectories", &mx::getSubdirectories);
     mod.def("loadDocuments", &mx::loadDocuments,
@@ -22,7 +32,8 @@ void bindPyUtil(py::module& mod)
     mod.def("loadLibrary", &mx::loadLibrary,
         py::arg("file"), py::arg("doc"), py::arg("searchPath") = mx::FileSearchPath(), py::arg("readOptions") = (mx::XmlReadOptions*) nullptr);
     mod.def("loadLibraries", &mx::loadLibraries,
-        py::arg("libraryFolders"), py::arg("searchPath"), py::arg("doc"), py::arg("excludeFiles") = mx::StringSet(), py::arg("readOptions") = (mx::XmlReadOptions*) nullptr);
+        py::arg("libraryFolders"), py::arg("searchPath"), py::arg("doc"), py::arg("excludeFiles") = mx::StringSet(), py::arg("readOptions") = (mx::XmlReadOptions*) nullptr,
+        py::arg("loadOptions") = (mx::LibraryLoadOptions*) nullptr, py::arg("statistics") = (mx::LibraryLoadStatistics*) nullptr);
     mod.def("flattenFilenames", &mx::flattenFilenames,
         py::arg("doc"), py::arg("searchPath") = mx::FileSearchPath(), py::arg("customResolver") = (mx::StringResolverPtr) nullptr);
     mod.def("getSourceSearchPath", &mx::getSourceSearchPath);
@@ -19,6 +19,11 @@ void bindPyXmlIo(py::module& mod)
         .def_readwrite("readComments", &mx::XmlReadOptions::readComments)
         .def_readwrite("readNewlines", &mx::XmlReadOptions::readNewlines)
         .def_readwrite("upgradeVersion", &mx::XmlReadOptions::upgradeVersion)        
+        .def_readwrite("upgradeVersionCallback", &mx::XmlReadOptions::upgradeVersionCallback)
+        .def_readwrite("skipDataLibraryXIncludes", &mx::XmlReadOptions::skipDataLibraryXIncludes)
+        .def_readwrite("streamingRead", &mx::XmlReadOptions::streamingRead)
+        .def_readwrite("elementPredicate", &mx::XmlReadOptions::elementPredicate)
+        .def_readwrite("deferNodeGraphBodies", &mx::XmlReadOptions::deferNodeGraphBodies)
         .def_readwrite("parentXIncludes", &mx::XmlReadOptions::parentXIncludes);
 
     py::class_<mx::XmlWriteOptions>(mod, "XmlWriteOptions")
@@ -15,6 +15,12 @@ void bindPyGenContext(py::module& mod)
 {
     py::class_<mx::ApplicationVariableHandler>(mod, "ApplicationVariableHandler");
 
+    py::class_<mx::ShaderNodeImplRegistry, mx::ShaderNodeImplRegistryPtr>(mod, "ShaderNodeImplRegistry")
+        .def_static("create", &mx::ShaderNodeImplRegistry::create)
+        .def(py::init<>())
+        .def("size", &mx::ShaderNodeImplRegistry::size)
+        .def("clear", &mx::ShaderNodeImplRegistry::clear);
+
     py::class_<mx::GenContext, mx::GenContextPtr>(mod, "GenContext")
         .def(py::init<mx::ShaderGeneratorPtr>())
         .def("getShaderGenerator", &mx::GenContext::getShaderGenerator)
@@ -22,7 +28,13 @@ void bindPyGenContext(py::module& mod)
         .def("getTypeDesc", &mx::GenContext::getTypeDesc)
         .def("registerSourceCodeSearchPath", static_cast<void (mx::GenContext::*)(const mx::FilePath&)>(&mx::GenContext::registerSourceCodeSearchPath))
         .def("registerSourceCodeSearchPath", static_cast<void (mx::GenContext::*)(const mx::FileSearchPath&)>(&mx::GenContext::registerSourceCodeSearchPath))
+        .def("getSourceCodeSearchPath", &mx::GenContext::getSourceCodeSearchPath)
         .def("resolveSourceFile", &mx::GenContext::resolveSourceFile)
+        .def("setFileSearchCache", &mx::GenContext::setFileSearchCache)
+        .def("getFileSearchCache", &mx::GenContext::getFileSearchCache)
+        .def("setNodeImplRegistry", &mx::GenContext::setNodeImplRegistry)
+        .def("getNodeImplRegistry", &mx::GenContext::getNodeImplRegistry)
+        .def("getConfigurationHash", &mx::GenContext::getConfigurationHash)
         .def("pushUserData", &mx::GenContext::pushUserData)
         .def("setApplicationVariableHandler", &mx::GenContext::setApplicationVariableHandler)
         .def("getApplicationVariableHandler", &mx::GenContext::getApplicationVariableHandler);
@@ -21,6 +21,7 @@ void bindPyShaderTranslator(py::module& mod);
 void bindPyUtil(py::module& mod);
 void bindPyTypeDesc(py::module& mod);
 void bindPyUnitSystem(py::module& mod);
+void bindPyShaderCache(py::module& mod);
 
 PYBIND11_MODULE(PyMaterialXGenShader, mod)
 {
@@ -40,4 +41,5 @@ PYBIND11_MODULE(PyMaterialXGenShader, mod)
     bindPyTypeDesc(mod);
     bindPyUnitSystem(mod);
     bindPyHwResourceBindingContext(mod);
+    bindPyShaderCache(mod);
 }
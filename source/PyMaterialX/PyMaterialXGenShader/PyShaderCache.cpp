@@ -0,0 +1,31 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <PyMaterialX/PyMaterialX.h>
+
+#include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/ShaderCache.h>
+
+namespace py = pybind11;
+namespace mx = MaterialX;
+
+void bindPyShaderCache(py::module& mod)
+{
+    py::class_<mx::ShaderCacheStatistics>(mod, "ShaderCacheStatistics")
+        .def(py::init<>())
+        .def_readwrite("memoryHits", &mx::ShaderCacheStatistics::memoryHits)
+        .def_readwrite("diskHits", &mx::ShaderCacheStatistics::diskHits)
+        .def_readwrite("misses", &mx::ShaderCacheStatistics::misses)
+        .def_readwrite("invalidations", &mx::ShaderCacheStatistics::invalidations);
+
+    py::class_<mx::ShaderCache, mx::ShaderCachePtr>(mod, "ShaderCache")
+        .def_static("create", &mx::ShaderCache::create, py::arg("storePath") = mx::FilePath())
+        .def(py::init<const mx::FilePath&>(), py::arg("storePath") = mx::FilePath())
+        .def("generate", &mx::ShaderCache::generate)
+        .def("computeKey", &mx::ShaderCache::computeKey)
+        .def("clear", &mx::ShaderCache::clear)
+        .def("getStorePath", &mx::ShaderCache::getStorePath)
+        .def("getStatistics", &mx::ShaderCache::getStatistics);
+}